@@ -0,0 +1,207 @@
+#define _GNU_SOURCE // pthread_setaffinity_np, CPU_SET
+#include "affinity.h"
+#include "runway.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+
+// Global affinity configuration
+Affinity affinity = {.policy = SCHED_OTHER};
+
+static const char *affinity_policy_name(int policy)
+{
+    switch (policy)
+    {
+    case SCHED_FIFO:
+        return "SCHED_FIFO";
+    case SCHED_RR:
+        return "SCHED_RR";
+    default:
+        return "SCHED_OTHER";
+    }
+}
+
+// Parse a CPU list such as "0-3,6" (-C). CPUs this process may not run on
+// are dropped with a warning; if none are left the threads stay unpinned.
+int affinity_set_cpus(Affinity *aff, const char *list)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        CPU_ZERO(&allowed);
+
+    cpu_set_t seen;
+    CPU_ZERO(&seen);
+    aff->cpu_count = 0;
+    const char *p = list;
+    while (*p != '\0')
+    {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p || first < 0)
+            return -1;
+        if (*end == '-')
+        {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first)
+                return -1;
+        }
+        if (last >= AFFINITY_MAX_CPUS || last >= CPU_SETSIZE)
+            return -1;
+        if (*end != ',' && *end != '\0')
+            return -1;
+        p = (*end == ',') ? end + 1 : end;
+
+        for (long cpu = first; cpu <= last; cpu++)
+        {
+            if (CPU_ISSET(cpu, &seen))
+                continue;
+            CPU_SET(cpu, &seen);
+            if (!CPU_ISSET(cpu, &allowed))
+            {
+                fprintf(stderr, "Warning: CPU %ld is not available to this process; not pinning to it\n", cpu);
+                continue;
+            }
+            aff->cpus[aff->cpu_count++] = (int)cpu;
+        }
+    }
+    if (aff->cpu_count == 0)
+        fprintf(stderr, "Warning: None of the CPUs in %s are available; threads stay unpinned\n", list);
+    return 0;
+}
+
+// Scheduling policy named by a -R spec (SCHED_FIFO or SCHED_RR), or -1
+int affinity_realtime_policy(const char *spec)
+{
+    const char *colon = strchr(spec, ':');
+    size_t name_length = (colon != NULL) ? (size_t)(colon - spec) : strlen(spec);
+    if (name_length == 4 && strncmp(spec, "fifo", 4) == 0)
+        return SCHED_FIFO;
+    if (name_length == 2 && strncmp(spec, "rr", 2) == 0)
+        return SCHED_RR;
+    return -1;
+}
+
+// Parse fifo[:priority] or rr[:priority] (-R). Whether the request is
+// allowed is only known when a thread applies it.
+int affinity_set_realtime(Affinity *aff, const char *spec)
+{
+    int policy = affinity_realtime_policy(spec);
+    if (policy < 0)
+        return -1;
+
+    const char *colon = strchr(spec, ':');
+    int priority = AFFINITY_DEFAULT_PRIORITY;
+    if (colon != NULL)
+    {
+        char *end;
+        priority = (int)strtol(colon + 1, &end, 10);
+        if (end == colon + 1 || *end != '\0')
+            return -1;
+    }
+    if (priority < sched_get_priority_min(policy) || priority > sched_get_priority_max(policy))
+        return -1;
+
+    aff->policy = policy;
+    aff->priority = priority;
+    return 0;
+}
+
+int affinity_enabled(Affinity *aff)
+{
+    return aff->cpu_count > 0 || aff->policy != SCHED_OTHER;
+}
+
+// Pin the calling thread and raise its priority for its role. Failures are
+// counted and the thread keeps running where the kernel put it.
+void affinity_apply(Affinity *aff, AffinityRole role)
+{
+    if (aff->cpu_count > 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (role == AFFINITY_DISPATCHER || aff->cpu_count == 1)
+        {
+            CPU_SET(aff->cpus[0], &set);
+        }
+        else if (role == AFFINITY_WORKER)
+        {
+            int n = atomic_fetch_add(&aff->next_worker, 1);
+            CPU_SET(aff->cpus[1 + n % (aff->cpu_count - 1)], &set);
+        }
+        else
+        {
+            for (int i = 1; i < aff->cpu_count; i++)
+                CPU_SET(aff->cpus[i], &set);
+        }
+
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+            atomic_fetch_add(&aff->pinned, 1);
+        else
+            atomic_fetch_add(&aff->pin_failed, 1);
+    }
+
+    if (aff->policy != SCHED_OTHER && !atomic_load(&aff->realtime_denied))
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = aff->priority;
+        // The dispatcher runs one level above, unless the planes already have the top one
+        if (role == AFFINITY_DISPATCHER && aff->priority < sched_get_priority_max(aff->policy))
+            param.sched_priority++;
+
+        int rc = pthread_setschedparam(pthread_self(), aff->policy, &param);
+        if (rc == 0)
+        {
+            atomic_fetch_add(&aff->realtime, 1);
+        }
+        else if (atomic_exchange(&aff->realtime_denied, 1) == 0)
+        {
+            // Reported once; every later thread skips the request
+            runway_print_status("[AFFINITY] %s priority %d refused (%s); running at normal priority",
+                                affinity_policy_name(aff->policy), aff->priority,
+                                rc == EPERM ? "needs CAP_SYS_NICE or RLIMIT_RTPRIO" : "not supported");
+        }
+    }
+}
+
+// One-line summary of the configuration for the parameter list
+void affinity_describe(Affinity *aff, char *buffer, size_t size)
+{
+    size_t used = 0;
+    if (aff->cpu_count == 0)
+    {
+        used = snprintf(buffer, size, "not pinned");
+    }
+    else if (aff->cpu_count == 1)
+    {
+        used = snprintf(buffer, size, "all on CPU %d", aff->cpus[0]);
+    }
+    else
+    {
+        used = snprintf(buffer, size, "dispatcher on CPU %d", aff->cpus[0]);
+        for (int i = 1; i < aff->cpu_count && used < size; i++)
+            used += snprintf(buffer + used, size - used, "%s%d", i == 1 ? ", others on CPUs " : ",", aff->cpus[i]);
+    }
+    if (used < size && aff->policy != SCHED_OTHER)
+        snprintf(buffer + used, size - used, ", %s priority %d", affinity_policy_name(aff->policy), aff->priority);
+}
+
+// Counts printed at shutdown
+void affinity_report(Affinity *aff)
+{
+    if (!affinity_enabled(aff))
+        return;
+    if (aff->cpu_count > 0)
+        runway_print_status("[AFFINITY] %ld threads pinned, %ld pin requests failed",
+                            atomic_load(&aff->pinned), atomic_load(&aff->pin_failed));
+    if (aff->policy != SCHED_OTHER)
+        runway_print_status("[AFFINITY] %ld threads on %s priority %d%s",
+                            atomic_load(&aff->realtime), affinity_policy_name(aff->policy), aff->priority,
+                            atomic_load(&aff->realtime_denied) ? " (refused, see above)" : "");
+}
@@ -0,0 +1,47 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define AFFINITY_MAX_CPUS 256
+#define AFFINITY_DEFAULT_PRIORITY 10 // -R fifo / -R rr without a priority
+
+// Threads on the scheduling path. The dispatcher (or the virtual-time loop)
+// gets the first listed CPU to itself; engine workers take the other CPUs
+// round-robin and plane threads share them.
+typedef enum
+{
+    AFFINITY_DISPATCHER,
+    AFFINITY_WORKER,
+    AFFINITY_PLANE
+} AffinityRole;
+
+// CPU pinning and real-time priority for the scheduling path. Observer
+// threads (logger, event bus, GUI, event log, metrics) are left alone.
+typedef struct
+{
+    int cpus[AFFINITY_MAX_CPUS];
+    int cpu_count;              // 0 = threads are not pinned
+    int policy;                 // SCHED_FIFO, SCHED_RR or SCHED_OTHER (no request)
+    int priority;               // Plane and worker threads; the dispatcher gets one more
+    atomic_int next_worker;
+    atomic_int realtime_denied; // Set by the first refused request; later threads skip it
+    atomic_long pinned;
+    atomic_long pin_failed;
+    atomic_long realtime;
+} Affinity;
+
+// Global affinity configuration
+extern Affinity affinity;
+
+// Affinity functions
+int affinity_set_cpus(Affinity *aff, const char *list);
+int affinity_realtime_policy(const char *spec);
+int affinity_set_realtime(Affinity *aff, const char *spec);
+int affinity_enabled(Affinity *aff);
+void affinity_apply(Affinity *aff, AffinityRole role);
+void affinity_describe(Affinity *aff, char *buffer, size_t size);
+void affinity_report(Affinity *aff);
+
+#endif // AFFINITY_H
@@ -0,0 +1,380 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include "runway.h"
+#include "plane.h"
+#include "queue.h"
+#include "pool.h"
+#include "workload.h"
+#include "affinity.h"
+
+// Microbenchmarks for the scheduler primitives (built by `make bench`).
+// Output is CSV: one row per benchmark and thread count.
+
+#define BENCH_DEFAULT_QUEUE_OPS 200000
+#define BENCH_DEFAULT_GRANTS 2000
+#define BENCH_DEFAULT_PREEMPTIONS 20
+#define BENCH_MAX_PRODUCERS 64
+
+static long long bench_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void bench_sleep_ms(int ms)
+{
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Sort samples and print one CSV row
+static void bench_report(const char *name, int threads, long long *samples, long count, long long elapsed_ns)
+{
+    qsort(samples, count, sizeof(long long), bench_compare);
+    double ops_per_sec = elapsed_ns > 0 ? count * 1e9 / elapsed_ns : 0.0;
+    printf("%s,%d,%ld,%.0f,%lld,%lld,%lld\n", name, threads, count, ops_per_sec,
+           samples[count * 50 / 100], samples[count * 99 / 100], samples[count * 999 / 1000]);
+    fflush(stdout);
+}
+
+// queue_enqueue/queue_dequeue with N producers and one consumer
+
+typedef struct
+{
+    Queue *queue;
+    Plane *planes;
+    long count;
+    long long *latency;
+    pthread_barrier_t *start;
+} ProducerArgs;
+
+static void *bench_producer(void *arg)
+{
+    ProducerArgs *args = (ProducerArgs *)arg;
+    pthread_barrier_wait(args->start);
+    for (long i = 0; i < args->count; i++)
+    {
+        long long t0 = bench_now_ns();
+        queue_enqueue(args->queue, &args->planes[i]);
+        args->latency[i] = bench_now_ns() - t0;
+    }
+    pool_thread_flush();
+    return NULL;
+}
+
+static void bench_queue(int producers, long total_ops)
+{
+    Queue queue;
+    queue_init(&queue);
+
+    long per_producer = total_ops / producers;
+    long total = per_producer * producers;
+    Plane *planes = (Plane *)calloc(total, sizeof(Plane));
+    long long *enqueue_latency = (long long *)malloc(total * sizeof(long long));
+    long long *dequeue_latency = (long long *)malloc(total * sizeof(long long));
+    ProducerArgs args[BENCH_MAX_PRODUCERS];
+    pthread_t threads[BENCH_MAX_PRODUCERS];
+    pthread_barrier_t start;
+    if (planes == NULL || enqueue_latency == NULL || dequeue_latency == NULL)
+    {
+        perror("Failed to allocate benchmark buffers");
+        exit(1);
+    }
+    pthread_barrier_init(&start, NULL, producers + 1);
+
+    for (int p = 0; p < producers; p++)
+    {
+        args[p].queue = &queue;
+        args[p].planes = planes + p * per_producer;
+        args[p].count = per_producer;
+        args[p].latency = enqueue_latency + p * per_producer;
+        args[p].start = &start;
+        pthread_create(&threads[p], NULL, bench_producer, &args[p]);
+    }
+
+    // This thread is the single consumer
+    pthread_barrier_wait(&start);
+    long long begin = bench_now_ns();
+    long dequeued = 0;
+    while (dequeued < total)
+    {
+        long long t0 = bench_now_ns();
+        if (queue_dequeue(&queue) != NULL)
+            dequeue_latency[dequeued++] = bench_now_ns() - t0;
+    }
+    long long elapsed = bench_now_ns() - begin;
+
+    for (int p = 0; p < producers; p++)
+        pthread_join(threads[p], NULL);
+    pool_thread_flush();
+
+    bench_report("queue_enqueue", producers, enqueue_latency, total, elapsed);
+    bench_report("queue_dequeue", producers, dequeue_latency, total, elapsed);
+
+    pthread_barrier_destroy(&start);
+    queue_destroy(&queue);
+    free(planes);
+    free(enqueue_latency);
+    free(dequeue_latency);
+}
+
+// Grant latency: runway_release() until the next waiting plane holds the runway
+
+typedef struct
+{
+    Plane *plane;
+    sem_t go;
+    sem_t done;
+    long long granted_ns;
+    int stop;
+} Waiter;
+
+// Plays one plane thread: queue up, wait for the grant, note the time
+static void *bench_waiter(void *arg)
+{
+    Waiter *waiter = (Waiter *)arg;
+    affinity_apply(&affinity, AFFINITY_PLANE);
+    while (1)
+    {
+        sem_wait(&waiter->go);
+        if (waiter->stop)
+            break;
+        runway_enqueue_waiting(&runway_system, waiter->plane);
+        sem_post(&runway_system.dispatch_sem);
+        runway_request_access(waiter->plane);
+        waiter->granted_ns = bench_now_ns();
+        sem_post(&waiter->done);
+    }
+    pool_thread_flush();
+    return NULL;
+}
+
+// Wait until the dispatcher has seen the queued plane (or granted it)
+static void bench_wait_queued(int count)
+{
+    while (runway_waiting_count(&runway_system, NORMAL) + runway_waiting_count(&runway_system, EMERGENCY) < count)
+        sched_yield();
+}
+
+static void bench_grant(int grants)
+{
+    long long *latency = (long long *)malloc(grants * sizeof(long long));
+    Plane planes[2];
+    Waiter waiter;
+    pthread_t thread;
+    if (latency == NULL)
+    {
+        perror("Failed to allocate benchmark buffers");
+        exit(1);
+    }
+
+    for (int i = 0; i < 2; i++)
+        plane_init(&planes[i], i + 1, LANDING, NORMAL);
+    sem_init(&waiter.go, 0, 0);
+    sem_init(&waiter.done, 0, 0);
+    waiter.stop = 0;
+    pthread_create(&thread, NULL, bench_waiter, &waiter);
+
+    // Plane 0 starts on the runway
+    runway_enqueue_waiting(&runway_system, &planes[0]);
+    sem_post(&runway_system.dispatch_sem);
+    runway_request_access(&planes[0]);
+
+    long long begin = bench_now_ns();
+    for (int i = 0; i < grants; i++)
+    {
+        Plane *holder = &planes[i % 2];
+        waiter.plane = &planes[(i + 1) % 2];
+        sem_post(&waiter.go);
+        bench_wait_queued(1);
+
+        long long t0 = bench_now_ns();
+        runway_release(holder);
+        sem_wait(&waiter.done);
+        latency[i] = waiter.granted_ns - t0;
+    }
+    long long elapsed = bench_now_ns() - begin;
+
+    runway_release(&planes[grants % 2]);
+    waiter.stop = 1;
+    sem_post(&waiter.go);
+    pthread_join(thread, NULL);
+
+    bench_report("grant_latency", 1, latency, grants, elapsed);
+
+    for (int i = 0; i < 2; i++)
+        plane_destroy(&planes[i]);
+    sem_destroy(&waiter.go);
+    sem_destroy(&waiter.done);
+    free(latency);
+}
+
+// Preemption latency: emergency arrival until the emergency holds the runway
+// that a normal plane was using (runs the real checkpoint loop)
+
+static void *bench_holder(void *arg)
+{
+    Plane *plane = (Plane *)arg;
+    runway_enqueue_waiting(&runway_system, plane);
+    sem_post(&runway_system.dispatch_sem);
+    runway_request_access(plane);
+    runway_perform_operation(plane);
+    runway_release(plane);
+    pool_thread_flush();
+    return NULL;
+}
+
+// True once plane is back on a runway and past its grant
+static int bench_holding(Plane *plane)
+{
+    sem_wait(&runway_system.sched_sem);
+    int holding = plane->runway_id >= 0 && plane->state == USING_RUNWAY;
+    sem_post(&runway_system.sched_sem);
+    return holding;
+}
+
+static void bench_preemption(int preemptions)
+{
+    Rng rng;
+    rng_seed(&rng, (uint64_t)bench_now_ns(), 0);
+    long long *latency = (long long *)malloc(preemptions * sizeof(long long));
+    Plane holder;
+    Plane emergency;
+    pthread_t thread;
+    if (latency == NULL)
+    {
+        perror("Failed to allocate benchmark buffers");
+        exit(1);
+    }
+
+    // Long enough that the holder never finishes while being measured
+    runway_system.config.landing_duration = 3600;
+    plane_init(&holder, 1, LANDING, NORMAL);
+    pthread_create(&thread, NULL, bench_holder, &holder);
+
+    long long begin = bench_now_ns();
+    for (int i = 0; i < preemptions; i++)
+    {
+        while (!bench_holding(&holder))
+            bench_sleep_ms(1);
+        // Arrive at a random point within a checkpoint interval
+        bench_sleep_ms(rng_below(&rng, CHECKPOINT_INTERVAL_MS));
+
+        plane_init(&emergency, 2, TAKEOFF, EMERGENCY);
+        long long t0 = bench_now_ns();
+        runway_enqueue_waiting(&runway_system, &emergency);
+        sem_post(&runway_system.dispatch_sem);
+        runway_request_access(&emergency);
+        latency[i] = bench_now_ns() - t0;
+
+        // Let the holder finish at its next checkpoint after the last sample
+        if (i == preemptions - 1)
+            runway_system.config.landing_duration = 1;
+        runway_release(&emergency);
+        plane_destroy(&emergency);
+    }
+    long long elapsed = bench_now_ns() - begin;
+
+    pthread_join(thread, NULL);
+    plane_destroy(&holder);
+
+    bench_report("preemption_latency", 1, latency, preemptions, elapsed);
+    free(latency);
+}
+
+static void bench_usage(const char *program_name)
+{
+    printf("Usage: %s [-q <queue ops>] [-g <grants>] [-p <preemptions>] [-C <cpus>] [-R <policy>[:<prio>]]\n",
+           program_name);
+    printf("  -q <ops>     Queue operations per producer count (default: %d)\n", BENCH_DEFAULT_QUEUE_OPS);
+    printf("  -g <grants>  Runway handoffs measured (default: %d)\n", BENCH_DEFAULT_GRANTS);
+    printf("  -p <count>   Emergency preemptions measured (default: %d)\n", BENCH_DEFAULT_PREEMPTIONS);
+    printf("  -C <cpus>    Pin the dispatcher and plane threads as the simulator's -C does\n");
+    printf("  -R <policy>  Real-time priority for them: fifo[:<prio>] or rr[:<prio>]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    long queue_ops = BENCH_DEFAULT_QUEUE_OPS;
+    int grants = BENCH_DEFAULT_GRANTS;
+    int preemptions = BENCH_DEFAULT_PREEMPTIONS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "q:g:p:C:R:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'q':
+            queue_ops = atol(optarg);
+            break;
+        case 'g':
+            grants = atoi(optarg);
+            break;
+        case 'p':
+            preemptions = atoi(optarg);
+            break;
+        case 'C':
+            if (affinity_set_cpus(&affinity, optarg) != 0)
+            {
+                fprintf(stderr, "Error: Invalid CPU list %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'R':
+            if (affinity_set_realtime(&affinity, optarg) != 0)
+            {
+                fprintf(stderr, "Error: Invalid real-time priority %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'h':
+            bench_usage(argv[0]);
+            return 0;
+        default:
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (queue_ops < BENCH_MAX_PRODUCERS || grants <= 0 || preemptions <= 0)
+    {
+        fprintf(stderr, "Error: Need at least %d queue ops and one grant and preemption\n", BENCH_MAX_PRODUCERS);
+        return 1;
+    }
+
+    runway_quiet = 1;
+    pool_init(&plane_pool, "plane", sizeof(Plane));
+    pool_init(&plane_cold_pool, "plane-cold", sizeof(PlaneCold));
+    pool_init(&queue_node_pool, "queue-node", sizeof(QueueNode));
+    runway_init(&runway_system, 1, 1);
+
+    printf("benchmark,threads,ops,ops_per_sec,p50_ns,p99_ns,p999_ns\n");
+    for (int producers = 1; producers <= BENCH_MAX_PRODUCERS; producers *= 2)
+        bench_queue(producers, queue_ops);
+
+    // The main thread plays the releasing and preempted planes in the runway benchmarks
+    affinity_apply(&affinity, AFFINITY_PLANE);
+    runway_start_dispatcher(&runway_system);
+    bench_grant(grants);
+    bench_preemption(preemptions);
+    runway_stop_dispatcher(&runway_system);
+
+    runway_destroy(&runway_system);
+    pool_destroy(&queue_node_pool);
+    pool_destroy(&plane_pool);
+    pool_destroy(&plane_cold_pool);
+    return 0;
+}
@@ -0,0 +1,459 @@
+#define _POSIX_C_SOURCE 200809L
+#include "bus.h"
+#include "runway.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+// Global event bus instance
+EventBus event_bus;
+
+// Ring the calling thread used last; it usually gets the same one back
+static _Thread_local int bus_ring_hint = 0;
+
+// Order two events by timestamp, then by position in their rings
+static int bus_compare(const BusEvent *ea, const BusEvent *eb)
+{
+    if (ea->stamp_ns != eb->stamp_ns)
+        return (ea->stamp_ns < eb->stamp_ns) ? -1 : 1;
+    return (ea->seq < eb->seq) ? -1 : (ea->seq > eb->seq);
+}
+
+// Hand every waiting event to the subscriber; returns events delivered.
+// The rings are merged by timestamp, so a batch cut short at BUS_BATCH_SIZE
+// holds the earliest waiting events and nothing later than what it leaves.
+// Tails move only after the handler returns, so bus_stop() also waits for
+// the output of the last batch.
+static int bus_flush(BusSubscriber *sub, BusEvent *batch)
+{
+    unsigned long tails[BUS_MAX_RINGS];
+    unsigned long heads[BUS_MAX_RINGS];
+    int pending[BUS_MAX_RINGS]; // Rings with events left to merge
+    int rings = 0;
+    int count = 0;
+
+    for (int i = 0; i < BUS_MAX_RINGS; i++)
+    {
+        BusRing *ring = &sub->rings[i];
+        tails[i] = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        heads[i] = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tails[i] != heads[i])
+            pending[rings++] = i;
+    }
+
+    while (rings > 0 && count < BUS_BATCH_SIZE)
+    {
+        int next = 0;
+        for (int r = 1; r < rings; r++)
+        {
+            const BusRing *a = &sub->rings[pending[r]];
+            const BusRing *b = &sub->rings[pending[next]];
+            if (bus_compare(&a->events[tails[pending[r]] & (BUS_RING_SIZE - 1)],
+                            &b->events[tails[pending[next]] & (BUS_RING_SIZE - 1)]) < 0)
+                next = r;
+        }
+
+        int i = pending[next];
+        batch[count++] = sub->rings[i].events[tails[i] & (BUS_RING_SIZE - 1)];
+        if (++tails[i] == heads[i])
+            pending[next] = pending[--rings];
+    }
+    if (count == 0)
+        return 0;
+
+    sub->handler(batch, count, sub->arg);
+    for (int i = 0; i < count; i++)
+    {
+        if (batch[i].type == BUS_STATUS)
+            free(batch[i].text);
+    }
+
+    for (int i = 0; i < BUS_MAX_RINGS; i++)
+        atomic_store_explicit(&sub->rings[i].tail, tails[i], memory_order_release);
+    atomic_fetch_add_explicit(&sub->delivered, count, memory_order_relaxed);
+
+    // Wake publishers sleeping on a full ring
+    for (int waiters = atomic_exchange(&sub->space_waiters, 0); waiters > 0; waiters--)
+        sem_post(&sub->space_sem);
+    return count;
+}
+
+// Subscriber thread: deliver every BUS_FLUSH_INTERVAL_MS until stopped and drained
+static void *bus_subscriber_thread(void *arg)
+{
+    BusSubscriber *sub = (BusSubscriber *)arg;
+    BusEvent *batch = (BusEvent *)malloc(BUS_BATCH_SIZE * sizeof(BusEvent));
+    if (batch == NULL)
+    {
+        perror("Failed to allocate event bus batch");
+        exit(1);
+    }
+
+    while (1)
+    {
+        int delivered = bus_flush(sub, batch);
+        if (delivered == BUS_BATCH_SIZE || (atomic_load(&sub->stop) && delivered > 0))
+            continue; // Still behind, keep draining
+        if (atomic_load(&sub->stop))
+            break;
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += BUS_FLUSH_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (sem_timedwait(&sub->wakeup_sem, &deadline) != 0 && errno == EINTR)
+            ;
+    }
+
+    free(batch);
+    logger_thread_release(&logger);
+    return NULL;
+}
+
+// Add a subscriber for the event types in interest (one bit per BusEventType)
+// and start its thread. Subscribe before the first publish.
+int bus_subscribe(EventBus *bus, const char *name, unsigned interest, int block_when_full,
+                  BusHandler handler, void *arg)
+{
+    int index = atomic_load(&bus->subscriber_count);
+    if (index == BUS_MAX_SUBSCRIBERS)
+    {
+        fprintf(stderr, "Error: Too many event bus subscribers\n");
+        return -1;
+    }
+
+    BusSubscriber *sub = &bus->subscribers[index];
+    sub->name = name;
+    sub->handler = handler;
+    sub->arg = arg;
+    sub->interest = interest;
+    sub->block_when_full = block_when_full;
+    atomic_store(&sub->stop, 0);
+    atomic_init(&sub->delivered, 0);
+    atomic_init(&sub->dropped, 0);
+    atomic_init(&sub->space_waiters, 0);
+    sem_init(&sub->wakeup_sem, 0, 0); // Counting semaphore (initially 0)
+    sem_init(&sub->space_sem, 0, 0);  // Counting semaphore (initially 0)
+    for (int i = 0; i < BUS_MAX_RINGS; i++)
+    {
+        atomic_init(&sub->rings[i].head, 0);
+        atomic_init(&sub->rings[i].tail, 0);
+        sub->rings[i].events = (BusEvent *)malloc(BUS_RING_SIZE * sizeof(BusEvent));
+        if (sub->rings[i].events == NULL)
+        {
+            perror("Failed to allocate event bus ring");
+            return -1;
+        }
+    }
+
+    if (pthread_create(&sub->thread, NULL, bus_subscriber_thread, sub) != 0)
+    {
+        perror("Failed to create event bus subscriber thread");
+        return -1;
+    }
+    atomic_store(&bus->subscriber_count, index + 1);
+    atomic_fetch_or(&bus->interest, interest);
+    return 0;
+}
+
+// Claim a ring index for one publish (free rings are tried from the hint on)
+static int bus_claim_ring(EventBus *bus)
+{
+    int i = bus_ring_hint;
+    while (1)
+    {
+        int expected = 0;
+        if (atomic_compare_exchange_strong_explicit(&bus->claimed[i], &expected, 1,
+                                                    memory_order_acquire, memory_order_relaxed))
+        {
+            bus_ring_hint = i;
+            return i;
+        }
+        i = (i + 1) % BUS_MAX_RINGS;
+        if (i == bus_ring_hint)
+            sched_yield(); // Every ring is busy
+    }
+}
+
+// Append to one subscriber's ring; returns 0 if the event was dropped. A
+// full ring drops the event, unless the subscriber asked for
+// BUS_BLOCK_WHEN_FULL: then the publisher sleeps until the subscriber has
+// handled a batch.
+static int bus_push(EventBus *bus, BusSubscriber *sub, BusRing *ring, BusEvent *event)
+{
+    unsigned long head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= BUS_RING_SIZE)
+    {
+        if (!sub->block_when_full)
+        {
+            atomic_fetch_add_explicit(&sub->dropped, 1, memory_order_relaxed);
+            return 0;
+        }
+
+        atomic_fetch_add_explicit(&bus->stalls, 1, memory_order_relaxed);
+        do
+        {
+            // A wakeup meant for an earlier wait only costs one more check
+            atomic_fetch_add(&sub->space_waiters, 1);
+            sem_post(&sub->wakeup_sem);
+            tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+            if (head - tail < BUS_RING_SIZE)
+                break;
+            while (sem_wait(&sub->space_sem) != 0 && errno == EINTR)
+                ;
+            tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        } while (head - tail >= BUS_RING_SIZE);
+    }
+
+    event->seq = head;
+    ring->events[head & (BUS_RING_SIZE - 1)] = *event;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    // Wake the subscriber early once a ring is half full
+    if (head - tail == BUS_RING_SIZE / 2)
+        sem_post(&sub->wakeup_sem);
+    return 1;
+}
+
+// Stamp an event and hand it to every subscriber that wants its type;
+// returns the number of subscribers that took it. A BUS_STATUS line is
+// copied for each of them.
+int bus_publish(EventBus *bus, BusEvent *event)
+{
+    const char *text = event->text;
+    int taken = 0;
+    event->stamp_ns = runway_clock_ns();
+    int index = bus_claim_ring(bus);
+    int subscribers = atomic_load_explicit(&bus->subscriber_count, memory_order_acquire);
+    for (int s = 0; s < subscribers; s++)
+    {
+        BusSubscriber *sub = &bus->subscribers[s];
+        if (!((sub->interest >> event->type) & 1u))
+            continue;
+        if (event->type == BUS_STATUS && (event->text = strdup(text)) == NULL)
+            continue;
+        if (bus_push(bus, sub, &sub->rings[index], event))
+            taken++;
+        else if (event->type == BUS_STATUS)
+            free(event->text);
+    }
+    atomic_store_explicit(&bus->claimed[index], 0, memory_order_release);
+    atomic_fetch_add_explicit(&bus->published, 1, memory_order_relaxed);
+    return taken;
+}
+
+// Publish an event about one plane (use BUS_PUBLISH)
+void bus_publish_plane(EventBus *bus, BusEventType type, Plane *plane, int runway, long long value)
+{
+    BusEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.plane_id = plane->id;
+    event.runway = runway;
+    event.value = value;
+    event.priority = plane->priority;
+    event.operation = plane->operation;
+    event.progress = (unsigned char)plane->checkpoint_progress;
+    bus_publish(bus, &event);
+}
+
+// Publish planes first_id..last_id arriving together (use BUS_PUBLISH_BATCH)
+void bus_publish_batch(EventBus *bus, int first_id, int last_id, int emergencies, int normals,
+                       int queued_emergency, int queued_normal)
+{
+    BusEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = BUS_BATCH;
+    event.plane_id = first_id;
+    event.runway = -1;
+    event.value = last_id;
+    event.count[EMERGENCY] = emergencies;
+    event.count[NORMAL] = normals;
+    event.queued[EMERGENCY] = queued_emergency;
+    event.queued[NORMAL] = queued_normal;
+    bus_publish(bus, &event);
+}
+
+// Publish a formatted status line, so subscribers print it after the events
+// published before it; returns 0 if none took it and the caller must print it
+int bus_publish_status(EventBus *bus, const char *text)
+{
+    BusEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = BUS_STATUS;
+    event.plane_id = -1;
+    event.runway = -1;
+    event.text = (char *)text;
+    return bus_publish(bus, &event) > 0;
+}
+
+// Deliver what is left, stop every subscriber thread and unsubscribe them
+void bus_stop(EventBus *bus)
+{
+    int subscribers = atomic_load(&bus->subscriber_count);
+    atomic_store(&bus->interest, 0);
+    atomic_store(&bus->subscriber_count, 0);
+
+    for (int s = 0; s < subscribers; s++)
+    {
+        BusSubscriber *sub = &bus->subscribers[s];
+        atomic_store(&sub->stop, 1);
+        sem_post(&sub->wakeup_sem);
+        pthread_join(sub->thread, NULL);
+        for (int i = 0; i < BUS_MAX_RINGS; i++)
+        {
+            free(sub->rings[i].events);
+            sub->rings[i].events = NULL;
+        }
+        sem_destroy(&sub->wakeup_sem);
+        sem_destroy(&sub->space_sem);
+
+        long dropped = atomic_load(&sub->dropped);
+        if (dropped > 0)
+            runway_print_status("[BUS] %s: %ld events delivered, %ld dropped on ring overflow",
+                                sub->name, atomic_load(&sub->delivered), dropped);
+    }
+}
+
+// Sink for bus_render(): receives the status line as a format and its arguments
+typedef int (*BusEmitFunction)(void *ctx, const char *format, ...);
+
+// Hand an event's status line to emit; returns 0 for events without one.
+// Formats are literals and string arguments come from the *_to_string tables,
+// so the asynchronous logger can keep them by pointer.
+static int bus_render(const BusEvent *event, BusEmitFunction emit, void *ctx)
+{
+    const char *operation = operation_to_string((OperationType)event->operation);
+    const char *priority = priority_to_string((PriorityLevel)event->priority);
+
+    switch (event->type)
+    {
+    case BUS_ARRIVAL:
+        return emit(ctx, "[ARRIVAL] Plane %d (%s, %s) requesting runway access",
+                    event->plane_id, priority, operation);
+    case BUS_QUEUED:
+        return emit(ctx, "[%s] Plane %d added to %s queue (Queue size: %lld)",
+                    event->priority == EMERGENCY ? "EMERGENCY" : "QUEUE", event->plane_id, priority, event->value);
+    case BUS_BATCH:
+        return emit(ctx, "[ARRIVAL] Planes %d-%lld arrived together: %d emergency, %d normal "
+                         "(Queue sizes: %d emergency, %d normal)",
+                    event->plane_id, event->value, event->count[EMERGENCY], event->count[NORMAL],
+                    event->queued[EMERGENCY], event->queued[NORMAL]);
+    case BUS_GRANTED:
+        return emit(ctx, "[GRANTED] %s Plane %d granted runway %d", priority, event->plane_id, event->runway + 1);
+    case BUS_STARTED:
+        if (event->progress > 0)
+            return emit(ctx, "[RESUME] Plane %d resuming %s from %d%% (remaining: %llds)",
+                        event->plane_id, operation, (int)event->progress, event->value);
+        return emit(ctx, "[OPERATION] Plane %d starting %s (duration: %llds)",
+                    event->plane_id, operation, event->value);
+    case BUS_PREEMPTED:
+        return emit(ctx, "[PREEMPTED] Plane %d interrupted at %d%% - yielding to emergency",
+                    event->plane_id, (int)event->progress);
+    case BUS_REQUEUED:
+        return emit(ctx, "[REQUEUE] Plane %d re-queued to NORMAL queue with checkpoint at %d%%",
+                    event->plane_id, (int)event->progress);
+    case BUS_FINISHED:
+        return emit(ctx, "[FINISHED] Plane %d completed %s operation", event->plane_id, operation);
+    case BUS_RELEASED:
+        return emit(ctx, "[RELEASE] Plane %d released runway %d", event->plane_id, event->runway + 1);
+    case BUS_COMPLETED:
+        return emit(ctx, "[COMPLETED] Plane %d finished %s (Total time: %.3f seconds)",
+                    event->plane_id, operation, event->value / 1e9);
+    case BUS_STATUS:
+        // The text is freed after delivery, so it is never handed to the logger
+        return emit(ctx, "%s", event->text);
+    default:
+        return 0;
+    }
+}
+
+typedef struct
+{
+    char *buffer;
+    size_t size;
+} BusText;
+
+static int bus_emit_text(void *ctx, const char *format, ...)
+{
+    BusText *text = (BusText *)ctx;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text->buffer, text->size, format, args);
+    va_end(args);
+    return 1;
+}
+
+// Buffer the line in the asynchronous logger at the event's time;
+// returns 1 if buffered (or dropped by the logger), -1 to print it here
+static int bus_emit_logger(void *ctx, const char *format, ...)
+{
+    const BusEvent *event = (const BusEvent *)ctx;
+    va_list args;
+    va_start(args, format);
+    int buffered = logger_vwrite(&logger, event->stamp_ns, format, args);
+    va_end(args);
+    return (buffered == 0) ? 1 : -1;
+}
+
+// Render an event as its status line; returns 0 for events without one
+int bus_describe(const BusEvent *event, char *buffer, size_t size)
+{
+    BusText text = {buffer, size};
+    return bus_render(event, bus_emit_text, &text);
+}
+
+// Console subscriber: one write per batch of status lines, or with -A the
+// lines go to the logger thread like every other status line. A BUS_STATUS
+// line is printed here once the logger has written the lines before it.
+void bus_console_handler(const BusEvent *events, int count, void *arg)
+{
+    (void)arg;
+    static char text[64 * 1024];
+    size_t used = 0;
+
+    sem_wait(&runway_system.console_access);
+    for (int i = 0; i < count; i++)
+    {
+        if (logger_enabled && events[i].type == BUS_STATUS)
+        {
+            if (used > 0)
+                fwrite(text, 1, used, stdout);
+            used = 0;
+            sem_post(&runway_system.console_access); // The logger thread prints under it
+            logger_drain(&logger);
+            sem_wait(&runway_system.console_access);
+        }
+        else if (logger_enabled && bus_render(&events[i], bus_emit_logger, (void *)&events[i]) >= 0)
+            continue;
+
+        char time_str[32];
+        char message[512];
+        if (!bus_describe(&events[i], message, sizeof(message)))
+            continue;
+        runway_format_clock(events[i].stamp_ns, time_str, sizeof(time_str));
+
+        if (used + sizeof(time_str) + sizeof(message) + 4 > sizeof(text))
+        {
+            fwrite(text, 1, used, stdout);
+            used = 0;
+        }
+        used += snprintf(text + used, sizeof(text) - used, "[%s] %s\n", time_str, message);
+    }
+    if (used > 0)
+    {
+        fwrite(text, 1, used, stdout);
+        fflush(stdout);
+    }
+    sem_post(&runway_system.console_access);
+}
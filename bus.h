@@ -0,0 +1,136 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include "plane.h"
+
+#define BUS_MAX_SUBSCRIBERS 4
+#define BUS_MAX_RINGS 16        // Publishers that can write at the same moment
+#define BUS_RING_SIZE 1024      // Events per ring (power of two)
+#define BUS_BATCH_SIZE 1024     // Events handed to a subscriber per flush
+#define BUS_FLUSH_INTERVAL_MS 20
+
+// What a publisher does when a subscriber's ring is full (bus_subscribe)
+#define BUS_DROP_WHEN_FULL 0    // Count the event as dropped and carry on
+#define BUS_BLOCK_WHEN_FULL 1   // Sleep until the subscriber frees a slot
+
+// Plane lifecycle events published by the runway core
+typedef enum
+{
+    BUS_ARRIVAL,    // Plane requests runway access
+    BUS_QUEUED,     // value: waiting planes at its priority level
+    BUS_BATCH,      // Planes plane_id..value arrived together (count, queued)
+    BUS_GRANTED,
+    BUS_STARTED,    // value: duration, or remaining seconds when resuming (progress > 0)
+    BUS_CHECKPOINT,
+    BUS_PREEMPTED,
+    BUS_REQUEUED,
+    BUS_FINISHED,
+    BUS_RELEASED,
+    BUS_COMPLETED,  // value: nanoseconds from arrival to completion
+    BUS_STATUS,     // text: a runway_print_status() line, printed in order with the events
+    BUS_EVENT_TYPES
+} BusEventType;
+
+#define BUS_ALL_EVENTS ((1u << BUS_EVENT_TYPES) - 1)
+
+// Fixed-size event record, copied out of the plane at publish time
+typedef struct
+{
+    long long stamp_ns;     // runway_clock_ns() when published
+    unsigned long seq;      // Position in its ring
+    long long value;        // Type-specific (see BusEventType)
+    int plane_id;
+    int runway;             // Runway index, -1 when not on a runway
+    int count[2];           // BUS_BATCH: planes per PriorityLevel
+    int queued[2];          // BUS_BATCH: waiting planes per PriorityLevel afterwards
+    char *text;             // BUS_STATUS: the line (each subscriber's copy, freed after delivery)
+    unsigned char type;     // BusEventType
+    unsigned char priority; // PriorityLevel
+    unsigned char operation;
+    unsigned char progress;
+} BusEvent;
+
+// Called on the subscriber's own thread with events in publish order
+typedef void (*BusHandler)(const BusEvent *events, int count, void *arg);
+
+// Single-producer/single-consumer ring: one publisher at a time holds its
+// index (EventBus.claimed), and one subscriber thread reads it
+typedef struct
+{
+    atomic_ulong head;      // Next slot the publisher writes
+    atomic_ulong tail;      // Next slot the subscriber has finished with
+    BusEvent *events;
+} BusRing;
+
+typedef struct
+{
+    const char *name;
+    BusHandler handler;
+    void *arg;
+    unsigned interest;      // Bit per BusEventType
+    int block_when_full;    // BUS_BLOCK_WHEN_FULL or BUS_DROP_WHEN_FULL
+    BusRing rings[BUS_MAX_RINGS];
+    pthread_t thread;
+    sem_t wakeup_sem;       // Counting semaphore: ring half full, drain or shutdown
+    sem_t space_sem;        // Counting semaphore: slots freed for blocked publishers
+    atomic_int space_waiters;
+    atomic_int stop;        // Set by bus_stop(); polled by the subscriber thread
+    atomic_long delivered;
+    atomic_long dropped;    // Events lost because the ring was full
+} BusSubscriber;
+
+// Event bus: the core publishes into per-subscriber rings and never waits on
+// an observer; a full ring drops the event unless its subscriber asked for
+// BUS_BLOCK_WHEN_FULL
+typedef struct
+{
+    BusSubscriber subscribers[BUS_MAX_SUBSCRIBERS];
+    atomic_int subscriber_count;
+    atomic_uint interest;              // Union of the subscribers' interest
+    atomic_int claimed[BUS_MAX_RINGS]; // Ring index held by a publisher
+    atomic_long published;
+    atomic_long stalls;                // Publishes that slept on a full blocking ring
+} EventBus;
+
+// Global event bus instance
+extern EventBus event_bus;
+
+// Publish calls. Arguments are only evaluated while some subscriber wants the
+// event type; a build with make BUS=off has no subscribers and compiles them away.
+#ifdef BUS_DISABLED
+#define BUS_WANTS(type) 0
+#else
+#define BUS_WANTS(type) \
+    ((atomic_load_explicit(&event_bus.interest, memory_order_relaxed) >> (type)) & 1u)
+#endif
+#define BUS_PUBLISH(type, plane, runway, value)                         \
+    do                                                                  \
+    {                                                                   \
+        if (BUS_WANTS(type))                                            \
+            bus_publish_plane(&event_bus, (type), (plane), (runway), (value)); \
+    } while (0)
+#define BUS_PUBLISH_BATCH(first_id, last_id, emergencies, normals, queued_emergency, queued_normal) \
+    do                                                                  \
+    {                                                                   \
+        if (BUS_WANTS(BUS_BATCH))                                       \
+            bus_publish_batch(&event_bus, (first_id), (last_id), (emergencies), (normals), \
+                              (queued_emergency), (queued_normal));     \
+    } while (0)
+
+// Event bus functions
+int bus_subscribe(EventBus *bus, const char *name, unsigned interest, int block_when_full,
+                  BusHandler handler, void *arg);
+int bus_publish(EventBus *bus, BusEvent *event);
+void bus_publish_plane(EventBus *bus, BusEventType type, Plane *plane, int runway, long long value);
+void bus_publish_batch(EventBus *bus, int first_id, int last_id, int emergencies, int normals,
+                       int queued_emergency, int queued_normal);
+int bus_publish_status(EventBus *bus, const char *text);
+void bus_stop(EventBus *bus);
+int bus_describe(const BusEvent *event, char *buffer, size_t size);
+void bus_console_handler(const BusEvent *events, int count, void *arg);
+
+#endif // BUS_H
@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 200809L // sem_timedwait
+
+#include "engine.h"
+#include "runway.h"
+#include "pool.h"
+#include "logger.h"
+#include "affinity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+// Global engine instance
+Engine engine;
+
+// Milliseconds elapsed since the engine started
+static long long engine_now_ms()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - engine.start.tv_sec) * 1000LL +
+           (now.tv_nsec - engine.start.tv_nsec) / 1000000;
+}
+
+// Schedule a state machine event and wake a worker to re-arm its timer
+static void engine_schedule(long long time_ms, SimEventType type, Plane *plane)
+{
+    sem_wait(&engine.timers_sem);
+    event_queue_push(&engine.timers, time_ms, type, plane);
+    sem_post(&engine.timers_sem);
+
+    sem_post(&engine.wakeup_sem);
+}
+
+static const SimDriver engine_driver = {engine_now_ms, engine_schedule};
+
+// Sleep until the deadline or until a new event is scheduled
+static void engine_wait(Engine *eng, long long deadline_ms)
+{
+    if (deadline_ms < 0)
+    {
+        sem_wait(&eng->wakeup_sem);
+        return;
+    }
+
+    long long delay_ms = deadline_ms - engine_now_ms();
+    if (delay_ms <= 0)
+        return;
+
+    struct timespec abs_timeout;
+    clock_gettime(CLOCK_REALTIME, &abs_timeout);
+    abs_timeout.tv_sec += delay_ms / 1000;
+    abs_timeout.tv_nsec += (delay_ms % 1000) * 1000000;
+    if (abs_timeout.tv_nsec >= 1000000000)
+    {
+        abs_timeout.tv_sec++;
+        abs_timeout.tv_nsec -= 1000000000;
+    }
+
+    while (sem_timedwait(&eng->wakeup_sem, &abs_timeout) == -1 && errno == EINTR)
+        ;
+}
+
+// Mark the run finished and wake every sleeping worker so it can exit
+static void engine_finish(Engine *eng)
+{
+    sem_wait(&eng->timers_sem);
+    int was_finished = eng->finished;
+    eng->finished = 1;
+    sem_post(&eng->timers_sem);
+
+    if (!was_finished)
+    {
+        for (int i = 0; i < eng->worker_count; i++)
+            sem_post(&eng->wakeup_sem);
+    }
+}
+
+// Worker thread: pop due events and advance the owning plane's state machine.
+// Only the pop is serialized; transitions for different planes run in parallel.
+static void *engine_worker(void *arg)
+{
+    Engine *eng = (Engine *)arg;
+
+    affinity_apply(&affinity, AFFINITY_WORKER);
+    while (1)
+    {
+        SimEvent event;
+        long long deadline_ms = -1;
+        int due = 0;
+
+        sem_wait(&eng->timers_sem);
+        if (eng->finished)
+        {
+            sem_post(&eng->timers_sem);
+            break;
+        }
+        if (eng->timers.count > 0)
+        {
+            deadline_ms = eng->timers.events[0].time_ms;
+            if (deadline_ms <= engine_now_ms())
+                due = event_queue_pop(&eng->timers, &event);
+        }
+        eng->events_processed += due;
+        sem_post(&eng->timers_sem);
+
+        if (due)
+        {
+            sim_handle_event(&event);
+            if (sim_finished())
+                engine_finish(eng);
+            continue;
+        }
+
+        engine_wait(eng, deadline_ms);
+    }
+
+    pool_thread_flush();
+    logger_thread_release(&logger);
+    return NULL;
+}
+
+// Initialize engine
+void engine_init(Engine *eng, int worker_count)
+{
+    if (worker_count < 1)
+        worker_count = 1;
+    if (worker_count > ENGINE_MAX_WORKERS)
+        worker_count = ENGINE_MAX_WORKERS;
+
+    event_queue_init(&eng->timers);
+    sem_init(&eng->timers_sem, 0, 1); // Binary semaphore for timers
+    sem_init(&eng->wakeup_sem, 0, 0); // Counting semaphore (initially 0)
+
+    eng->finished = 0;
+    eng->worker_count = worker_count;
+    eng->events_processed = 0;
+}
+
+// Run the simulation on the worker pool until every plane has completed
+void engine_run(Engine *eng)
+{
+    clock_gettime(CLOCK_MONOTONIC, &eng->start);
+    eng->finished = 0;
+
+    sim_set_driver(&engine_driver);
+
+    // No worker is running yet
+    sim_start();
+    eng->finished = sim_finished(); // Empty trace
+
+    runway_print_status("[SYSTEM] Engine started with %d worker threads", eng->worker_count);
+
+    for (int i = 0; i < eng->worker_count; i++)
+    {
+        if (pthread_create(&eng->workers[i], NULL, engine_worker, eng) != 0)
+        {
+            fprintf(stderr, "Error: Failed to create engine worker %d\n", i);
+            eng->worker_count = i;
+            break;
+        }
+    }
+
+    for (int i = 0; i < eng->worker_count; i++)
+    {
+        pthread_join(eng->workers[i], NULL);
+    }
+
+    runway_print_status("[SYSTEM] Engine finished: %lld events processed", eng->events_processed);
+}
+
+// Destroy engine resources
+void engine_destroy(Engine *eng)
+{
+    event_queue_destroy(&eng->timers);
+    sem_destroy(&eng->timers_sem);
+    sem_destroy(&eng->wakeup_sem);
+}
@@ -0,0 +1,35 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include "sim.h"
+
+#define ENGINE_MAX_WORKERS 64
+
+// Event-driven execution engine: planes are state machines advanced by a
+// fixed pool of worker threads instead of one blocked thread per plane.
+// A plane has at most one pending event, so the worker that pops it owns the
+// plane until it schedules the next one; shared runway state is taken under
+// RunwaySystem.sched_sem, as in thread-per-plane mode.
+typedef struct
+{
+    EventQueue timers;    // Pending arrivals and checkpoints (wall-clock deadlines)
+    sem_t timers_sem;     // Binary semaphore to protect timers, finished and events_processed
+    sem_t wakeup_sem;     // Counting semaphore posted when a new deadline is scheduled
+    int finished;         // Set once every plane has completed
+    int worker_count;
+    pthread_t workers[ENGINE_MAX_WORKERS];
+    struct timespec start; // CLOCK_MONOTONIC origin for engine time
+    long long events_processed;
+} Engine;
+
+// Global engine instance
+extern Engine engine;
+
+// Engine functions
+void engine_init(Engine *eng, int worker_count);
+void engine_run(Engine *eng);
+void engine_destroy(Engine *eng);
+
+#endif // ENGINE_H
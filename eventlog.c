@@ -0,0 +1,336 @@
+#include "eventlog.h"
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+// Global event log instance
+EventLog event_log;
+int event_log_enabled = 0;
+
+// Deflate level for blocks: the writer thread has to keep up with the
+// scheduler, so favour speed over ratio
+#define EVENTLOG_DEFLATE_LEVEL 1
+
+// File header
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} EventLogHeader;
+
+// Transpose the records into byte planes (all delta low bytes, then all
+// delta second bytes, ...) so the mostly-zero high bytes and the small
+// type/runway/class fields sit together, which deflate compresses far better
+// than interleaved records. Plane ids are stored as the zigzag-encoded
+// difference from the previous record's id.
+static void eventlog_shuffle(const EventLogRecord *records, int count, uint8_t *shuffled)
+{
+    size_t width = sizeof(EventLogRecord);
+    uint32_t previous_id = 0;
+    for (int r = 0; r < count; r++)
+    {
+        EventLogRecord record = records[r];
+        int32_t diff = (int32_t)(record.plane_id - previous_id);
+        previous_id = record.plane_id;
+        record.plane_id = ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+
+        const uint8_t *raw = (const uint8_t *)&record;
+        for (size_t b = 0; b < width; b++)
+            shuffled[b * count + r] = raw[b];
+    }
+}
+
+// Inverse of eventlog_shuffle
+static void eventlog_unshuffle(const uint8_t *shuffled, int count, EventLogRecord *records)
+{
+    size_t width = sizeof(EventLogRecord);
+    uint32_t previous_id = 0;
+    for (int r = 0; r < count; r++)
+    {
+        uint8_t *raw = (uint8_t *)&records[r];
+        for (size_t b = 0; b < width; b++)
+            raw[b] = shuffled[b * count + r];
+        uint32_t zigzag = records[r].plane_id;
+        previous_id += (zigzag >> 1) ^ (0u - (zigzag & 1));
+        records[r].plane_id = previous_id;
+    }
+}
+
+// Compress one buffer and write it with a single fwrite
+static void eventlog_write_block(EventLog *el, EventLogBuffer *buffer)
+{
+    if (buffer->count == 0)
+        return;
+
+    size_t raw_size = buffer->count * sizeof(EventLogRecord);
+    eventlog_shuffle(buffer->records, buffer->count, el->shuffled);
+    EventLogBlock *block = (EventLogBlock *)el->packed;
+    uLongf packed = compressBound(raw_size);
+    if (compress2(el->packed + sizeof(EventLogBlock), &packed, el->shuffled, raw_size,
+                  EVENTLOG_DEFLATE_LEVEL) != Z_OK)
+    {
+        fprintf(stderr, "Error: Failed to compress event log block\n");
+        buffer->count = 0;
+        return;
+    }
+    block->record_count = buffer->count;
+    block->packed_size = (uint32_t)packed;
+    block->base_ns = buffer->base_ns;
+
+    size_t total = sizeof(EventLogBlock) + packed;
+    if (fwrite(el->packed, 1, total, el->file) == total)
+        el->bytes_written += total;
+    buffer->count = 0;
+}
+
+// Writer thread: write each full buffer, then hand it back
+static void *eventlog_writer(void *arg)
+{
+    EventLog *el = (EventLog *)arg;
+    while (1)
+    {
+        sem_wait(&el->full_sem);
+        if (el->stop)
+            break;
+        eventlog_write_block(el, &el->buffers[1 - el->active]);
+        sem_post(&el->free_sem);
+    }
+    return NULL;
+}
+
+// Create the log file and start the writer thread
+int eventlog_open(EventLog *el, const char *path)
+{
+    memset(el, 0, sizeof(*el));
+    el->file = fopen(path, "wb");
+    if (el->file == NULL)
+    {
+        perror("Failed to create event log");
+        return -1;
+    }
+
+    size_t raw_size = EVENTLOG_BLOCK_RECORDS * sizeof(EventLogRecord);
+    for (int i = 0; i < 2; i++)
+        el->buffers[i].records = (EventLogRecord *)malloc(raw_size);
+    el->shuffled = (uint8_t *)malloc(raw_size);
+    el->packed = (uint8_t *)malloc(sizeof(EventLogBlock) + compressBound(raw_size));
+    if (el->buffers[0].records == NULL || el->buffers[1].records == NULL || el->shuffled == NULL ||
+        el->packed == NULL)
+    {
+        perror("Failed to allocate event log buffers");
+        fclose(el->file);
+        el->file = NULL;
+        return -1;
+    }
+
+    // Large stdio buffer: blocks go out as big sequential writes
+    setvbuf(el->file, NULL, _IOFBF, 1 << 20);
+    EventLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, EVENTLOG_MAGIC, sizeof(EVENTLOG_MAGIC));
+    header.version = EVENTLOG_VERSION;
+    header.record_size = sizeof(EventLogRecord);
+    fwrite(&header, sizeof(header), 1, el->file);
+    el->bytes_written = sizeof(header);
+
+    sem_init(&el->lock, 0, 1);     // Binary semaphore for the active buffer
+    sem_init(&el->full_sem, 0, 0); // Counting semaphore (initially 0)
+    sem_init(&el->free_sem, 0, 1); // The spare buffer starts free
+    if (pthread_create(&el->thread, NULL, eventlog_writer, el) != 0)
+    {
+        fprintf(stderr, "Error: Failed to create event log writer\n");
+        fclose(el->file);
+        el->file = NULL;
+        return -1;
+    }
+    event_log_enabled = 1;
+    return 0;
+}
+
+// Hand the active buffer to the writer and continue in the spare one
+// (caller holds el->lock)
+static void eventlog_swap(EventLog *el)
+{
+    sem_wait(&el->free_sem);
+    el->active = 1 - el->active;
+    sem_post(&el->full_sem);
+}
+
+// Append one event. Timestamps that arrive slightly out of order from
+// concurrent threads are clamped to the previous record.
+void eventlog_record(EventLog *el, int64_t stamp_ns, EventLogType type, int plane_id,
+                     int runway, int priority_class, int progress)
+{
+    sem_wait(&el->lock);
+
+    EventLogBuffer *buffer = &el->buffers[el->active];
+    if (stamp_ns < el->last_ns && buffer->count > 0)
+        stamp_ns = el->last_ns;
+    // Leave room for a clock record in front of this one
+    if (buffer->count >= EVENTLOG_BLOCK_RECORDS - 1)
+    {
+        eventlog_swap(el);
+        buffer = &el->buffers[el->active];
+    }
+    if (buffer->count == 0)
+    {
+        buffer->base_ns = stamp_ns;
+        el->last_ns = stamp_ns;
+    }
+
+    uint64_t delta = (uint64_t)(stamp_ns - el->last_ns);
+    EventLogRecord *record = &buffer->records[buffer->count++];
+    if (delta > UINT32_MAX)
+    {
+        memset(record, 0, sizeof(*record));
+        record->type = EVLOG_CLOCK;
+        record->plane_id = (uint32_t)(delta >> 32);
+        record = &buffer->records[buffer->count++];
+    }
+    record->delta_ns = (uint32_t)delta;
+    record->plane_id = (uint32_t)plane_id;
+    record->type = (uint8_t)type;
+    record->runway = (runway < 0) ? EVENTLOG_NO_RUNWAY : (uint8_t)runway;
+    record->priority_class = (uint8_t)priority_class;
+    record->progress = (uint8_t)progress;
+    el->last_ns = stamp_ns;
+    el->events++;
+
+    sem_post(&el->lock);
+}
+
+// Flush the remaining records, stop the writer and close the file
+void eventlog_close(EventLog *el)
+{
+    if (el->file == NULL)
+        return;
+
+    event_log_enabled = 0;
+    sem_wait(&el->lock);
+    sem_wait(&el->free_sem); // Writer is idle
+    el->stop = 1;
+    sem_post(&el->full_sem);
+    pthread_join(el->thread, NULL);
+    eventlog_write_block(el, &el->buffers[el->active]);
+    sem_post(&el->lock);
+
+    fclose(el->file);
+    el->file = NULL;
+    printf("[EVENTLOG] %ld events in %ld bytes (%.2f bytes/event)\n", el->events, el->bytes_written,
+           el->events > 0 ? (double)el->bytes_written / el->events : 0.0);
+
+    for (int i = 0; i < 2; i++)
+        free(el->buffers[i].records);
+    free(el->shuffled);
+    free(el->packed);
+    sem_destroy(&el->lock);
+    sem_destroy(&el->full_sem);
+    sem_destroy(&el->free_sem);
+}
+
+// Open a log and check its header
+int eventlog_reader_open(EventLogReader *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(path, "rb");
+    if (reader->file == NULL)
+        return -1;
+
+    EventLogHeader header;
+    if (fread(&header, sizeof(header), 1, reader->file) != 1 ||
+        memcmp(header.magic, EVENTLOG_MAGIC, sizeof(EVENTLOG_MAGIC)) != 0 ||
+        header.version != EVENTLOG_VERSION || header.record_size != sizeof(EventLogRecord))
+    {
+        fclose(reader->file);
+        reader->file = NULL;
+        return -1;
+    }
+
+    size_t raw_size = EVENTLOG_BLOCK_RECORDS * sizeof(EventLogRecord);
+    reader->records = (EventLogRecord *)malloc(raw_size);
+    reader->shuffled = (uint8_t *)malloc(raw_size);
+    reader->packed = (uint8_t *)malloc(compressBound(raw_size));
+    if (reader->records == NULL || reader->shuffled == NULL || reader->packed == NULL)
+    {
+        eventlog_reader_close(reader);
+        return -1;
+    }
+    return 0;
+}
+
+// Next event in file order; returns 1 on success, 0 at the end, -1 on a corrupt block
+int eventlog_reader_next(EventLogReader *reader, EventLogEntry *entry)
+{
+    if (reader->pos == reader->count)
+    {
+        EventLogBlock block;
+        if (fread(&block, sizeof(block), 1, reader->file) != 1)
+            return 0;
+        size_t raw_size = block.record_count * sizeof(EventLogRecord);
+        if (block.record_count == 0 || block.record_count > EVENTLOG_BLOCK_RECORDS ||
+            block.packed_size > compressBound(raw_size))
+            return -1;
+
+        uLongf unpacked = raw_size;
+        if (fread(reader->packed, 1, block.packed_size, reader->file) != block.packed_size ||
+            uncompress(reader->shuffled, &unpacked, reader->packed, block.packed_size) != Z_OK ||
+            unpacked != raw_size)
+            return -1;
+        eventlog_unshuffle(reader->shuffled, block.record_count, reader->records);
+        reader->count = block.record_count;
+        reader->pos = 0;
+        reader->stamp_ns = block.base_ns;
+    }
+
+    const EventLogRecord *record = &reader->records[reader->pos++];
+    if (record->type == EVLOG_CLOCK)
+    {
+        if (reader->pos == reader->count)
+            return -1;
+        reader->stamp_ns += (int64_t)record->plane_id << 32;
+        record = &reader->records[reader->pos++];
+    }
+    reader->stamp_ns += record->delta_ns;
+    entry->stamp_ns = reader->stamp_ns;
+    entry->type = (EventLogType)record->type;
+    entry->plane_id = (int)record->plane_id;
+    entry->runway = (record->runway == EVENTLOG_NO_RUNWAY) ? -1 : record->runway;
+    entry->priority_class = record->priority_class;
+    entry->progress = record->progress;
+    return 1;
+}
+
+void eventlog_reader_close(EventLogReader *reader)
+{
+    if (reader->file != NULL)
+        fclose(reader->file);
+    free(reader->records);
+    free(reader->shuffled);
+    free(reader->packed);
+    reader->file = NULL;
+    reader->records = NULL;
+    reader->shuffled = NULL;
+    reader->packed = NULL;
+}
+
+const char *eventlog_type_to_string(EventLogType type)
+{
+    switch (type)
+    {
+    case EVLOG_QUEUED:
+        return "QUEUED";
+    case EVLOG_REQUEUED:
+        return "REQUEUED";
+    case EVLOG_GRANTED:
+        return "GRANTED";
+    case EVLOG_PREEMPTED:
+        return "PREEMPTED";
+    case EVLOG_RELEASED:
+        return "RELEASED";
+    case EVLOG_COMPLETED:
+        return "COMPLETED";
+    default:
+        return "UNKNOWN";
+    }
+}
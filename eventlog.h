@@ -0,0 +1,115 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#define EVENTLOG_MAGIC "RWYEVLG"
+#define EVENTLOG_VERSION 1
+#define EVENTLOG_BLOCK_RECORDS 65536 // Records per block (one large write each)
+#define EVENTLOG_NO_RUNWAY 0xFF
+
+// Scheduling events recorded in the binary log
+typedef enum
+{
+    EVLOG_QUEUED,    // Plane arrived and joined a queue
+    EVLOG_REQUEUED,  // Preempted plane rejoined a queue
+    EVLOG_GRANTED,   // Runway granted (progress > 0 means a resume)
+    EVLOG_PREEMPTED, // Plane yielded its runway to an emergency
+    EVLOG_RELEASED,  // Plane finished and released its runway
+    EVLOG_COMPLETED, // Plane left the system
+    EVLOG_TYPE_COUNT,
+    EVLOG_CLOCK = 0xFF // Internal: extends the next delta past 32 bits
+} EventLogType;
+
+// Fixed-width 12-byte record; the timestamp is a delta from the previous
+// record in the block (the first one from the block's base time). Gaps too
+// long for 32 bits are preceded by an EVLOG_CLOCK record whose plane_id holds
+// the high half of the delta.
+typedef struct
+{
+    uint32_t delta_ns;
+    uint32_t plane_id;
+    uint8_t type;
+    uint8_t runway;         // Runway index or EVENTLOG_NO_RUNWAY
+    uint8_t priority_class;
+    uint8_t progress;       // Checkpoint progress 0-100
+} EventLogRecord;
+
+// On-disk block header, followed by packed_size bytes of deflated records
+typedef struct
+{
+    uint32_t record_count;
+    uint32_t packed_size;
+    int64_t base_ns;
+} EventLogBlock;
+
+// One buffer of the double-buffered writer
+typedef struct
+{
+    EventLogRecord *records;
+    int count;
+    int64_t base_ns;
+} EventLogBuffer;
+
+// Streaming writer: producers fill the active buffer, a background thread
+// compresses and writes the other one
+typedef struct
+{
+    FILE *file;
+    EventLogBuffer buffers[2];
+    int active;              // Buffer producers append to
+    int64_t last_ns;         // Timestamp of the latest record
+    uint8_t *shuffled;       // Writer thread's byte-plane scratch
+    uint8_t *packed;         // Writer thread's compression output
+    sem_t lock;              // Binary semaphore protecting the active buffer
+    sem_t full_sem;          // Posted when a buffer is handed to the writer
+    sem_t free_sem;          // Posted when the writer has finished with a buffer
+    pthread_t thread;
+    int stop;
+    long events;
+    long bytes_written;
+} EventLog;
+
+// Decoded event with its absolute timestamp
+typedef struct
+{
+    int64_t stamp_ns;
+    EventLogType type;
+    int plane_id;
+    int runway;             // -1 when not on a runway
+    int priority_class;
+    int progress;
+} EventLogEntry;
+
+// Sequential reader for the log file
+typedef struct
+{
+    FILE *file;
+    EventLogRecord *records;
+    uint8_t *shuffled;
+    uint8_t *packed;
+    int count;
+    int pos;
+    int64_t stamp_ns;
+} EventLogReader;
+
+// Global event log instance
+extern EventLog event_log;
+extern int event_log_enabled;
+
+// Writer functions
+int eventlog_open(EventLog *el, const char *path);
+void eventlog_record(EventLog *el, int64_t stamp_ns, EventLogType type, int plane_id,
+                     int runway, int priority_class, int progress);
+void eventlog_close(EventLog *el);
+
+// Reader functions
+int eventlog_reader_open(EventLogReader *reader, const char *path);
+int eventlog_reader_next(EventLogReader *reader, EventLogEntry *entry);
+void eventlog_reader_close(EventLogReader *reader);
+const char *eventlog_type_to_string(EventLogType type);
+
+#endif // EVENTLOG_H
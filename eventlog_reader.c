@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <string.h>
+#include "eventlog.h"
+
+// Convert a binary event log (written with -E) to CSV on stdout.
+// Built as runway_eventlog; links only eventlog.o.
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2 || strcmp(argv[1], "-h") == 0)
+    {
+        fprintf(stderr, "Usage: %s <event-log>\n", argv[0]);
+        fprintf(stderr, "Prints time_ns,event,plane,runway,class,progress for every recorded event.\n");
+        return (argc == 2) ? 0 : 1;
+    }
+
+    EventLogReader reader;
+    if (eventlog_reader_open(&reader, argv[1]) != 0)
+    {
+        fprintf(stderr, "Error: %s is not a readable event log\n", argv[1]);
+        return 1;
+    }
+
+    printf("time_ns,event,plane,runway,class,progress\n");
+    EventLogEntry entry;
+    long events = 0;
+    int status;
+    while ((status = eventlog_reader_next(&reader, &entry)) == 1)
+    {
+        printf("%lld,%s,%d,%d,%d,%d\n", (long long)entry.stamp_ns, eventlog_type_to_string(entry.type),
+               entry.plane_id, entry.runway, entry.priority_class, entry.progress);
+        events++;
+    }
+    eventlog_reader_close(&reader);
+
+    if (status < 0)
+    {
+        fprintf(stderr, "Error: Corrupt block after %ld events\n", events);
+        return 1;
+    }
+    return 0;
+}
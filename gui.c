@@ -1,13 +1,19 @@
+#define _POSIX_C_SOURCE 200809L
 #include "gui.h"
+#include "bus.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
 
 GUISystem gui_system;
 int gui_enabled = 0;
 
-// Initialize ncurses GUI
-void gui_init()
+static void *gui_render_thread(void *arg);
+static void gui_bus_handler(const BusEvent *events, int count, void *arg);
+
+// Initialize ncurses GUI; frames are drawn at frame_rate once gui_start() runs
+void gui_init(int frame_rate)
 {
     initscr();
     start_color();
@@ -36,15 +42,50 @@ void gui_init()
 
     gui_system.log_line = 0;
     gui_system.max_log_lines = max_y - 33;
+    if (gui_system.max_log_lines < 1)
+        gui_system.max_log_lines = 1;
+    gui_system.log_lines = (char (*)[GUI_LOG_WIDTH])calloc(gui_system.max_log_lines, GUI_LOG_WIDTH);
+    if (gui_system.log_lines == NULL)
+    {
+        endwin();
+        perror("Failed to allocate GUI log buffer");
+        exit(1);
+    }
 
     sem_init(&gui_system.gui_sem, 0, 1);
     scrollok(gui_system.log_win, TRUE);
 
     gui_draw_header();
-    gui_refresh_all();
+    doupdate();
+
+    gui_system.frame_rate = frame_rate;
+    atomic_init(&gui_system.render_stop, 0);
+    atomic_init(&gui_system.dirty, GUI_DIRTY_ALL);
+    atomic_init(&gui_system.frames_drawn, 0);
+    gui_system.render_started = 0;
     gui_enabled = 1;
 }
 
+// Start the render thread (the runway system must be initialized first)
+void gui_start()
+{
+    if (!gui_enabled) return;
+    if (pthread_create(&gui_system.render_thread, NULL, gui_render_thread, NULL) != 0)
+    {
+        endwin();
+        perror("Failed to create GUI render thread");
+        exit(1);
+    }
+    gui_system.render_started = 1;
+
+    // Lifecycle updates arrive from the event bus on their own thread
+    if (bus_subscribe(&event_bus, "gui", BUS_ALL_EVENTS, BUS_DROP_WHEN_FULL, gui_bus_handler, NULL) != 0)
+    {
+        endwin();
+        exit(1);
+    }
+}
+
 void gui_draw_header()
 {
     sem_wait(&gui_system.gui_sem);
@@ -55,13 +96,13 @@ void gui_draw_header()
     wattron(win, A_BOLD);
     mvwprintw(win, 1, (COLS - 60) / 2, "  AIRPORT RUNWAY MANAGEMENT SYSTEM - Real-Time Monitor  ");
     wattroff(win, A_BOLD);
-    wrefresh(win);
+    wnoutrefresh(win);
     sem_post(&gui_system.gui_sem);
 }
 
-void gui_draw_runway_visual(Plane *plane)
+// Draw a single runway in detail (renderer thread, caller holds gui_sem)
+void gui_draw_runway_visual(const GUIRunwaySnapshot *plane)
 {
-    sem_wait(&gui_system.gui_sem);
     WINDOW *win = gui_system.runway_win;
     werase(win);
     box(win, 0, 0);
@@ -70,10 +111,11 @@ void gui_draw_runway_visual(Plane *plane)
     mvwprintw(win, 0, 2, " RUNWAY STATUS ");
     wattroff(win, COLOR_PAIR(4) | A_BOLD);
 
-    if (plane != NULL)
+    if (plane->plane_id > 0)
     {
         int color = (plane->priority == EMERGENCY) ? 2 : 1;
-        
+
+
         mvwhline(win, 2, 2, ACS_HLINE, 40);
         wattron(win, A_BOLD);
         mvwprintw(win, 3, 3, "ACTIVE OPERATION");
@@ -82,7 +124,7 @@ void gui_draw_runway_visual(Plane *plane)
 
         mvwprintw(win, 6, 4, "Plane ID:");
         wattron(win, color | A_BOLD);
-        mvwprintw(win, 6, 22, "#%d", plane->id);
+        mvwprintw(win, 6, 22, "#%d", plane->plane_id);
         wattroff(win, color | A_BOLD);
 
         mvwprintw(win, 7, 4, "Priority:");
@@ -150,21 +192,115 @@ void gui_draw_runway_visual(Plane *plane)
         mvwprintw(win, 12, 5, "Waiting for next plane...");
     }
 
-    wrefresh(win);
-    sem_post(&gui_system.gui_sem);
+    wnoutrefresh(win);
 }
 
-void gui_update_runway(Plane *active_plane)
+// One line per runway when more than one is configured (caller holds gui_sem)
+void gui_draw_runway_table(const GUIRunwaySnapshot *runways, int count)
 {
-    if (!gui_enabled) return;
-    gui_draw_runway_visual(active_plane);
+    WINDOW *win = gui_system.runway_win;
+    werase(win);
+    box(win, 0, 0);
+
+    wattron(win, COLOR_PAIR(4) | A_BOLD);
+    mvwprintw(win, 0, 2, " RUNWAY STATUS (%d runways) ", count);
+    wattroff(win, COLOR_PAIR(4) | A_BOLD);
+
+    for (int i = 0; i < count && i < 14; i++)
+    {
+        const GUIRunwaySnapshot *plane = &runways[i];
+        int line = 2 + i;
+
+        wattron(win, A_BOLD);
+        mvwprintw(win, line, 2, "RWY %-2d", plane->runway_id);
+        wattroff(win, A_BOLD);
+        mvwprintw(win, line, 9, "%-7s", runway_role_to_string(plane->role));
+
+        if (plane->plane_id == 0)
+        {
+            wattron(win, COLOR_PAIR(1));
+            mvwprintw(win, line, 18, "idle");
+            wattroff(win, COLOR_PAIR(1));
+            continue;
+        }
+
+        int color = (plane->priority == EMERGENCY) ? 2 : 1;
+        wattron(win, COLOR_PAIR(color) | A_BOLD);
+        mvwprintw(win, line, 18, "#%-4d", plane->plane_id);
+        wattroff(win, COLOR_PAIR(color) | A_BOLD);
+        wattron(win, COLOR_PAIR(3));
+        mvwprintw(win, line, 24, "%-7s", operation_to_string(plane->operation));
+        wattroff(win, COLOR_PAIR(3));
+
+        int bar_width = 10;
+        int filled = (bar_width * plane->checkpoint_progress) / 100;
+        mvwaddch(win, line, 32, '[');
+        wattron(win, COLOR_PAIR(8) | A_BOLD);
+        for (int b = 0; b < filled; b++)
+            mvwaddch(win, line, 33 + b, ACS_CKBOARD);
+        wattroff(win, COLOR_PAIR(8) | A_BOLD);
+        mvwaddch(win, line, 33 + bar_width, ']');
+        mvwprintw(win, line, 35 + bar_width, "%3d%%", plane->checkpoint_progress);
+    }
+
+    wnoutrefresh(win);
 }
 
-void gui_update_queues()
+// Copy what the runway panel shows while the runway table is locked
+static int gui_snapshot_runways(GUIRunwaySnapshot *runways)
 {
-    if (!gui_enabled) return;
-    sem_wait(&gui_system.gui_sem);
+    sem_wait(&runway_system.sched_sem);
+    int count = runway_system.runway_count;
+    for (int i = 0; i < count; i++)
+    {
+        Runway *runway = &runway_system.runways[i];
+        Plane *plane = runway->active_plane;
+        runways[i].runway_id = runway->id;
+        runways[i].role = runway->role;
+        runways[i].plane_id = (plane != NULL) ? plane->id : 0;
+        if (plane != NULL)
+        {
+            runways[i].priority = plane->priority;
+            runways[i].operation = plane->operation;
+            runways[i].checkpoint_progress = plane->checkpoint_progress;
+        }
+    }
+    sem_post(&runway_system.sched_sem);
+    return count;
+}
 
+// Event bus subscriber: mark the panels each event changes and log its line
+static void gui_bus_handler(const BusEvent *events, int count, void *arg)
+{
+    (void)arg;
+    static const int panels[BUS_EVENT_TYPES] = {
+        [BUS_QUEUED] = GUI_DIRTY_QUEUES | GUI_DIRTY_STATS,
+        [BUS_BATCH] = GUI_DIRTY_QUEUES | GUI_DIRTY_STATS,
+        [BUS_GRANTED] = GUI_DIRTY_RUNWAY | GUI_DIRTY_QUEUES,
+        [BUS_CHECKPOINT] = GUI_DIRTY_RUNWAY,
+        [BUS_PREEMPTED] = GUI_DIRTY_RUNWAY | GUI_DIRTY_STATS,
+        [BUS_REQUEUED] = GUI_DIRTY_QUEUES,
+        [BUS_RELEASED] = GUI_DIRTY_RUNWAY | GUI_DIRTY_STATS,
+        [BUS_COMPLETED] = GUI_DIRTY_STATS,
+    };
+
+    int dirty = 0;
+    for (int i = 0; i < count; i++)
+    {
+        char time_str[32];
+        char message[256];
+        dirty |= panels[events[i].type];
+        if (!bus_describe(&events[i], message, sizeof(message)))
+            continue;
+        runway_format_clock(events[i].stamp_ns, time_str, sizeof(time_str));
+        gui_log_event("[%s] %s", time_str, message);
+    }
+    atomic_fetch_or(&gui_system.dirty, dirty);
+}
+
+// Draw both queue panels (renderer thread, caller holds gui_sem)
+static void gui_draw_queues()
+{
     WINDOW *emerg_win = gui_system.emergency_queue_win;
     werase(emerg_win);
     box(emerg_win, 0, 0);
@@ -172,7 +308,7 @@ void gui_update_queues()
     mvwprintw(emerg_win, 0, 2, " EMERGENCY QUEUE ");
     wattroff(emerg_win, COLOR_PAIR(2) | A_BOLD);
 
-    int emerg_count = queue_get_count(&runway_system.emergency_queue);
+    int emerg_count = runway_waiting_count(&runway_system, EMERGENCY);
     wattron(emerg_win, A_BOLD);
     mvwprintw(emerg_win, 1, 3, "Priority: HIGH");
     wattroff(emerg_win, A_BOLD);
@@ -183,11 +319,12 @@ void gui_update_queues()
     mvwhline(emerg_win, 2, 1, ACS_HLINE, 42);
 
     int line = 3;
-    QueueNode *node = runway_system.emergency_queue.head;
+    WaitingPlane visible[6];
+    int shown = runway_waiting_snapshot(&runway_system, EMERGENCY, visible, 6);
     int count = 0;
-    while (node != NULL && count < 6)
+    while (count < shown)
     {
-        Plane *p = node->plane;
+        WaitingPlane *p = &visible[count];
         wattron(emerg_win, COLOR_PAIR(2) | A_BOLD);
         mvwprintw(emerg_win, line, 3, "%d.", count + 1);
         wattroff(emerg_win, COLOR_PAIR(2) | A_BOLD);
@@ -198,7 +335,6 @@ void gui_update_queues()
         if (p->checkpoint_progress > 0)
             mvwprintw(emerg_win, line, 28, "(%d%%)", p->checkpoint_progress);
         line++;
-        node = node->next;
         count++;
     }
 
@@ -211,7 +347,7 @@ void gui_update_queues()
     else if (emerg_count > 6)
         mvwprintw(emerg_win, line, 3, "... +%d more", emerg_count - 6);
 
-    wrefresh(emerg_win);
+    wnoutrefresh(emerg_win);
 
     WINDOW *normal_win = gui_system.normal_queue_win;
     werase(normal_win);
@@ -220,7 +356,7 @@ void gui_update_queues()
     mvwprintw(normal_win, 0, 2, " NORMAL QUEUE ");
     wattroff(normal_win, COLOR_PAIR(1) | A_BOLD);
 
-    int normal_count = queue_get_count(&runway_system.normal_queue);
+    int normal_count = runway_waiting_count(&runway_system, NORMAL);
     wattron(normal_win, A_BOLD);
     mvwprintw(normal_win, 1, 3, "Priority: NORMAL");
     wattroff(normal_win, A_BOLD);
@@ -231,11 +367,11 @@ void gui_update_queues()
     mvwhline(normal_win, 2, 1, ACS_HLINE, 42);
 
     line = 3;
-    node = runway_system.normal_queue.head;
+    shown = runway_waiting_snapshot(&runway_system, NORMAL, visible, 6);
     count = 0;
-    while (node != NULL && count < 6)
+    while (count < shown)
     {
-        Plane *p = node->plane;
+        WaitingPlane *p = &visible[count];
         wattron(normal_win, COLOR_PAIR(1) | A_BOLD);
         mvwprintw(normal_win, line, 3, "%d.", count + 1);
         wattroff(normal_win, COLOR_PAIR(1) | A_BOLD);
@@ -246,7 +382,6 @@ void gui_update_queues()
         if (p->checkpoint_progress > 0)
             mvwprintw(normal_win, line, 28, "(%d%%)", p->checkpoint_progress);
         line++;
-        node = node->next;
         count++;
     }
 
@@ -259,15 +394,12 @@ void gui_update_queues()
     else if (normal_count > 6)
         mvwprintw(normal_win, line, 3, "... +%d more", normal_count - 6);
 
-    wrefresh(normal_win);
-    sem_post(&gui_system.gui_sem);
+    wnoutrefresh(normal_win);
 }
 
-void gui_update_stats()
+// Draw the statistics panel (renderer thread, caller holds gui_sem)
+static void gui_draw_stats()
 {
-    if (!gui_enabled) return;
-    sem_wait(&gui_system.gui_sem);
-
     WINDOW *stats_win = gui_system.stats_win;
     werase(stats_win);
     box(stats_win, 0, 0);
@@ -275,7 +407,10 @@ void gui_update_stats()
     mvwprintw(stats_win, 0, 2, " SIMULATION STATISTICS ");
     wattroff(stats_win, COLOR_PAIR(4) | A_BOLD);
 
-    int in_progress = runway_system.total_planes - runway_system.planes_completed;
+    int completed = (int)stats_read(&runway_stats, STAT_PLANES_COMPLETED);
+    int in_progress = runway_system.total_planes - completed;
+    PlaneCensus census;
+    plane_census(&census);
     mvwhline(stats_win, 2, 2, ACS_HLINE, 40);
 
     wattron(stats_win, A_BOLD);
@@ -289,7 +424,7 @@ void gui_update_stats()
     mvwprintw(stats_win, 5, 4, "Completed:");
     wattroff(stats_win, A_BOLD);
     wattron(stats_win, COLOR_PAIR(1) | A_BOLD);
-    mvwprintw(stats_win, 5, 28, "%3d", runway_system.planes_completed);
+    mvwprintw(stats_win, 5, 28, "%3d", completed);
     wattroff(stats_win, COLOR_PAIR(1) | A_BOLD);
 
     wattron(stats_win, A_BOLD);
@@ -305,12 +440,20 @@ void gui_update_stats()
     mvwprintw(stats_win, 8, 4, "Preemptions:");
     wattroff(stats_win, A_BOLD);
     wattron(stats_win, COLOR_PAIR(2) | A_BOLD);
-    mvwprintw(stats_win, 8, 28, "%3d", runway_system.preemptions_count);
+    mvwprintw(stats_win, 8, 28, "%3ld", stats_read(&runway_stats, STAT_PREEMPTIONS));
     wattroff(stats_win, COLOR_PAIR(2) | A_BOLD);
 
+    wattron(stats_win, A_BOLD);
+    mvwprintw(stats_win, 9, 4, "Waiting / On Runway:");
+    wattroff(stats_win, A_BOLD);
+    // Plane states differ between modes (threaded planes wait in APPROACHING),
+    // so the waiting figure comes from the waiting set itself
+    int waiting = runway_waiting_count(&runway_system, EMERGENCY) + runway_waiting_count(&runway_system, NORMAL);
+    mvwprintw(stats_win, 9, 28, "%3d / %d", waiting, census.states[USING_RUNWAY]);
+
     if (runway_system.total_planes > 0)
     {
-        int completion_pct = (runway_system.planes_completed * 100) / runway_system.total_planes;
+        int completion_pct = (completed * 100) / runway_system.total_planes;
         mvwhline(stats_win, 10, 2, ACS_HLINE, 40);
         wattron(stats_win, A_BOLD);
         mvwprintw(stats_win, 11, 4, "Overall Progress:");
@@ -332,53 +475,110 @@ void gui_update_stats()
         wattroff(stats_win, A_BOLD);
     }
 
-    wrefresh(stats_win);
-    sem_post(&gui_system.gui_sem);
+    wnoutrefresh(stats_win);
 }
 
+// Append a line to the event log; it appears on the next frame
 void gui_log_event(const char *format, ...)
 {
     if (!gui_enabled) return;
     sem_wait(&gui_system.gui_sem);
 
-    WINDOW *log_win = gui_system.log_win;
-    if (gui_system.log_line == 0)
-    {
-        werase(log_win);
-        box(log_win, 0, 0);
-        wattron(log_win, COLOR_PAIR(4) | A_BOLD);
-        mvwprintw(log_win, 0, 2, " EVENT LOG ");
-        wattroff(log_win, COLOR_PAIR(4) | A_BOLD);
-    }
-
     va_list args;
     va_start(args, format);
-    int current_line = (gui_system.log_line % gui_system.max_log_lines) + 1;
-    wmove(log_win, current_line, 2);
-    wclrtoeol(log_win);
-    vw_printw(log_win, format, args);
+    int slot = gui_system.log_line % gui_system.max_log_lines;
+    vsnprintf(gui_system.log_lines[slot], GUI_LOG_WIDTH, format, args);
     va_end(args);
-
     gui_system.log_line++;
+
+    sem_post(&gui_system.gui_sem);
+    atomic_fetch_or(&gui_system.dirty, GUI_DIRTY_LOG);
+}
+
+// Draw the event log oldest first; once the ring has wrapped the oldest line
+// is the one the next event will overwrite (caller holds gui_sem)
+static void gui_draw_log()
+{
+    WINDOW *log_win = gui_system.log_win;
+    werase(log_win);
+
+    int max_lines = gui_system.max_log_lines;
+    int lines = gui_system.log_line < max_lines ? gui_system.log_line : max_lines;
+    int first = gui_system.log_line < max_lines ? 0 : gui_system.log_line % max_lines;
+    for (int i = 0; i < lines; i++)
+        mvwaddnstr(log_win, i + 1, 2, gui_system.log_lines[(first + i) % max_lines], getmaxx(log_win) - 4);
+
     box(log_win, 0, 0);
     wattron(log_win, COLOR_PAIR(4) | A_BOLD);
     mvwprintw(log_win, 0, 2, " EVENT LOG ");
     wattroff(log_win, COLOR_PAIR(4) | A_BOLD);
-    wrefresh(log_win);
+    wnoutrefresh(log_win);
+}
+
+// Redraw every dirty panel and push them to the terminal in one doupdate()
+static void gui_render_frame()
+{
+    int dirty = atomic_exchange(&gui_system.dirty, 0);
+    if (dirty == 0)
+        return;
+
+    GUIRunwaySnapshot runways[MAX_RUNWAYS];
+    int runway_count = 0;
+    if (dirty & GUI_DIRTY_RUNWAY)
+        runway_count = gui_snapshot_runways(runways);
+
+    sem_wait(&gui_system.gui_sem);
+    if (dirty & GUI_DIRTY_RUNWAY)
+    {
+        if (runway_count > 1)
+            gui_draw_runway_table(runways, runway_count);
+        else
+            gui_draw_runway_visual(&runways[0]);
+    }
+    if (dirty & GUI_DIRTY_QUEUES)
+        gui_draw_queues();
+    if (dirty & GUI_DIRTY_STATS)
+        gui_draw_stats();
+    if (dirty & GUI_DIRTY_LOG)
+        gui_draw_log();
+    doupdate();
     sem_post(&gui_system.gui_sem);
+
+    atomic_fetch_add(&gui_system.frames_drawn, 1);
 }
 
+// Renderer thread: the only thread that touches the terminal while the GUI runs
+static void *gui_render_thread(void *arg)
+{
+    (void)arg;
+    long frame_ns = 1000000000L / gui_system.frame_rate;
+    struct timespec frame = {frame_ns / 1000000000L, frame_ns % 1000000000L};
+
+    while (!atomic_load(&gui_system.render_stop))
+    {
+        gui_render_frame();
+        nanosleep(&frame, NULL);
+    }
+    gui_render_frame(); // Last frame so nothing marked dirty is lost
+    return NULL;
+}
+
+// Mark every panel dirty
 void gui_refresh_all()
 {
     if (!gui_enabled) return;
-    gui_update_runway(runway_system.active_plane);
-    gui_update_queues();
-    gui_update_stats();
+    atomic_fetch_or(&gui_system.dirty, GUI_DIRTY_ALL);
 }
 
 void gui_destroy()
 {
     if (!gui_enabled) return;
+    if (gui_system.render_started)
+    {
+        atomic_store(&gui_system.render_stop, 1);
+        pthread_join(gui_system.render_thread, NULL);
+    }
+
     sem_wait(&gui_system.gui_sem);
     delwin(gui_system.header_win);
     delwin(gui_system.runway_win);
@@ -389,5 +589,6 @@ void gui_destroy()
     endwin();
     sem_post(&gui_system.gui_sem);
     sem_destroy(&gui_system.gui_sem);
+    free(gui_system.log_lines);
     gui_enabled = 0;
 }
@@ -2,10 +2,33 @@
 #define GUI_H
 
 #include <ncurses.h>
+#include <pthread.h>
 #include <semaphore.h>
+#include <stdatomic.h>
 #include "plane.h"
 #include "runway.h"
 
+#define GUI_DEFAULT_FRAME_RATE 10 // Frames per second
+#define GUI_LOG_WIDTH 160         // Characters kept per event log line
+
+// Panels that need redrawing on the next frame
+#define GUI_DIRTY_RUNWAY 0x1
+#define GUI_DIRTY_QUEUES 0x2
+#define GUI_DIRTY_STATS 0x4
+#define GUI_DIRTY_LOG 0x8
+#define GUI_DIRTY_ALL 0xF
+
+// What the runway panel shows for one runway, copied under sched_sem
+typedef struct
+{
+    int runway_id;
+    RunwayRole role;
+    int plane_id; // 0 when the runway is idle
+    PriorityLevel priority;
+    OperationType operation;
+    int checkpoint_progress;
+} GUIRunwaySnapshot;
+
 // GUI Windows
 typedef struct
 {
@@ -18,7 +41,15 @@ typedef struct
     WINDOW *log_win;
     int log_line;
     int max_log_lines;
-    sem_t gui_sem; // Protect GUI updates
+    char (*log_lines)[GUI_LOG_WIDTH]; // Event log text, max_log_lines entries
+    sem_t gui_sem; // Protect ncurses calls and the event log buffer
+
+    pthread_t render_thread;  // Only thread drawing to the terminal
+    int frame_rate;
+    int render_started;
+    atomic_int render_stop;   // Set by gui_destroy(); polled by the renderer
+    atomic_int dirty;         // GUI_DIRTY_* bits set by producers
+    atomic_long frames_drawn;
 } GUISystem;
 
 // Global GUI instance
@@ -26,14 +57,13 @@ extern GUISystem gui_system;
 extern int gui_enabled;
 
 // GUI functions
-void gui_init();
+void gui_init(int frame_rate);
+void gui_start();
 void gui_destroy();
-void gui_update_runway(Plane *active_plane);
-void gui_update_queues();
-void gui_update_stats();
 void gui_log_event(const char *format, ...);
 void gui_draw_header();
-void gui_draw_runway_visual(Plane *plane);
+void gui_draw_runway_visual(const GUIRunwaySnapshot *plane);
+void gui_draw_runway_table(const GUIRunwaySnapshot *runways, int count);
 void gui_refresh_all();
 
 #endif // GUI_H
@@ -0,0 +1,406 @@
+#define _POSIX_C_SOURCE 200809L
+#include "logger.h"
+#include "runway.h"
+#include "gui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+// Global logger instance
+Logger logger;
+int logger_enabled = 0;
+
+// Ring claimed by the calling thread (NULL until its first record)
+static _Thread_local LogRing *logger_ring = NULL;
+
+// Argument kinds found in a printf format
+typedef enum
+{
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LONG_LONG,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING
+} LogArgType;
+
+// Parse the conversion starting at format[0] == '%'. Stores the argument kind
+// and returns the length of the specifier, or 0 for an unsupported one.
+// "%%" returns 2 with *type set to -1.
+static int logger_parse_spec(const char *format, int *type)
+{
+    int i = 1;
+    int longs = 0;
+
+    if (format[i] == '%')
+    {
+        *type = -1;
+        return 2;
+    }
+    while (format[i] != '\0' && strchr("-+ #0123456789.", format[i]) != NULL)
+        i++;
+    while (format[i] == 'l')
+    {
+        longs++;
+        i++;
+    }
+
+    switch (format[i])
+    {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'c':
+        *type = (longs == 0) ? LOG_ARG_INT : (longs == 1) ? LOG_ARG_LONG : LOG_ARG_LONG_LONG;
+        return i + 1;
+    case 'f':
+    case 'g':
+    case 'e':
+        *type = LOG_ARG_DOUBLE;
+        return i + 1;
+    case 's':
+        *type = LOG_ARG_STRING;
+        return i + 1;
+    default:
+        return 0;
+    }
+}
+
+// Copy the arguments named by format into record; returns -1 if they don't fit
+static int logger_capture(LogRecord *record, const char *format, va_list args)
+{
+    record->arg_count = 0;
+    for (const char *p = format; *p != '\0'; p++)
+    {
+        if (*p != '%')
+            continue;
+
+        int type;
+        int len = logger_parse_spec(p, &type);
+        if (len == 0 || (type >= 0 && record->arg_count == LOG_MAX_ARGS))
+            return -1;
+        p += len - 1;
+        if (type < 0)
+            continue;
+
+        LogArg *arg = &record->args[record->arg_count++];
+        switch (type)
+        {
+        case LOG_ARG_INT:
+            arg->i = va_arg(args, int);
+            break;
+        case LOG_ARG_LONG:
+            arg->i = va_arg(args, long);
+            break;
+        case LOG_ARG_LONG_LONG:
+            arg->i = va_arg(args, long long);
+            break;
+        case LOG_ARG_DOUBLE:
+            arg->d = va_arg(args, double);
+            break;
+        case LOG_ARG_STRING:
+            arg->s = va_arg(args, const char *);
+            break;
+        }
+    }
+    return 0;
+}
+
+// Expand a captured record into text, one conversion at a time
+static void logger_format(const LogRecord *record, char *out, size_t size)
+{
+    size_t used = 0;
+    int next_arg = 0;
+    char spec[32];
+
+    out[0] = '\0';
+    for (const char *p = record->format; *p != '\0' && used + 1 < size; p++)
+    {
+        if (*p != '%')
+        {
+            out[used++] = *p;
+            out[used] = '\0';
+            continue;
+        }
+
+        int type;
+        int len = logger_parse_spec(p, &type);
+        if (type < 0)
+        {
+            out[used++] = '%';
+            out[used] = '\0';
+            p++;
+            continue;
+        }
+        snprintf(spec, sizeof(spec), "%.*s", len, p);
+        p += len - 1;
+
+        const LogArg *arg = &record->args[next_arg++];
+        int written = 0;
+        switch (type)
+        {
+        case LOG_ARG_INT:
+            written = snprintf(out + used, size - used, spec, (int)arg->i);
+            break;
+        case LOG_ARG_LONG:
+            written = snprintf(out + used, size - used, spec, (long)arg->i);
+            break;
+        case LOG_ARG_LONG_LONG:
+            written = snprintf(out + used, size - used, spec, arg->i);
+            break;
+        case LOG_ARG_DOUBLE:
+            written = snprintf(out + used, size - used, spec, arg->d);
+            break;
+        case LOG_ARG_STRING:
+            written = snprintf(out + used, size - used, spec, arg->s);
+            break;
+        }
+        if (written > 0)
+            used += ((size_t)written < size - used) ? (size_t)written : size - used - 1;
+    }
+}
+
+// Claim a free ring for the calling thread
+static LogRing *logger_claim_ring(Logger *lg)
+{
+    for (int i = 0; i < LOG_MAX_RINGS; i++)
+    {
+        LogRing *ring = &lg->rings[i];
+        int expected = 0;
+        if (!atomic_compare_exchange_strong(&ring->owned, &expected, 1))
+            continue;
+
+        if (ring->records == NULL)
+        {
+            ring->records = (LogRecord *)malloc(LOG_RING_SIZE * sizeof(LogRecord));
+            if (ring->records == NULL)
+            {
+                atomic_store(&ring->owned, 0);
+                return NULL;
+            }
+        }
+
+        // Publish the ring to the consumer's scan range
+        int count = atomic_load(&lg->ring_count);
+        while (count <= i && !atomic_compare_exchange_weak(&lg->ring_count, &count, i + 1))
+            ;
+        return ring;
+    }
+    return NULL;
+}
+
+// Buffer one record without blocking. Returns -1 if the caller should print
+// synchronously instead (no ring free, or arguments that can't be captured).
+int logger_vwrite(Logger *lg, long long stamp_ns, const char *format, va_list args)
+{
+    if (logger_ring == NULL)
+    {
+        logger_ring = logger_claim_ring(lg);
+        if (logger_ring == NULL)
+        {
+            atomic_fetch_add_explicit(&lg->fallbacks, 1, memory_order_relaxed);
+            return -1;
+        }
+    }
+
+    LogRing *ring = logger_ring;
+    unsigned long head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= LOG_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&lg->dropped, 1, memory_order_relaxed);
+        return 0;
+    }
+
+    LogRecord *record = &ring->records[head & (LOG_RING_SIZE - 1)];
+    record->stamp_ns = stamp_ns;
+    record->seq = head;
+    record->format = format;
+    if (logger_capture(record, format, args) != 0)
+    {
+        atomic_fetch_add_explicit(&lg->fallbacks, 1, memory_order_relaxed);
+        return -1;
+    }
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    atomic_fetch_add_explicit(&lg->written, 1, memory_order_relaxed);
+
+    // Wake the consumer early once a ring is half full
+    if (head - tail == LOG_RING_SIZE / 2)
+        sem_post(&lg->wakeup_sem);
+    return 0;
+}
+
+// Give the calling thread's ring back; records already in it are still flushed
+void logger_thread_release(Logger *lg)
+{
+    (void)lg;
+    if (logger_ring != NULL)
+    {
+        atomic_store_explicit(&logger_ring->owned, 0, memory_order_release);
+        logger_ring = NULL;
+    }
+}
+
+// Order a batch by timestamp, keeping each ring's own order on ties
+static int logger_compare(const void *a, const void *b)
+{
+    const LogRecord *ra = (const LogRecord *)a;
+    const LogRecord *rb = (const LogRecord *)b;
+    if (ra->stamp_ns != rb->stamp_ns)
+        return (ra->stamp_ns < rb->stamp_ns) ? -1 : 1;
+    return (ra->seq < rb->seq) ? -1 : (ra->seq > rb->seq);
+}
+
+// Drain every ring into batch, format and write it out; returns records written
+static int logger_flush(Logger *lg, LogRecord *batch, char *text, size_t text_size)
+{
+    int count = 0;
+    int rings = atomic_load(&lg->ring_count);
+
+    for (int i = 0; i < rings && count < LOG_BATCH_SIZE; i++)
+    {
+        LogRing *ring = &lg->rings[i];
+        unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned long head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        while (tail != head && count < LOG_BATCH_SIZE)
+        {
+            batch[count++] = ring->records[tail & (LOG_RING_SIZE - 1)];
+            tail++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    if (count == 0)
+        return 0;
+
+    qsort(batch, count, sizeof(LogRecord), logger_compare);
+
+    sem_wait(&runway_system.console_access);
+    size_t used = 0;
+    for (int i = 0; i < count; i++)
+    {
+        char time_str[32];
+        char message[256];
+        runway_format_clock(batch[i].stamp_ns, time_str, sizeof(time_str));
+        logger_format(&batch[i], message, sizeof(message));
+
+        if (gui_enabled)
+        {
+            gui_log_event("[%s] %s", time_str, message);
+            continue;
+        }
+
+        // One write per batch instead of printf + fflush per event
+        if (used + sizeof(time_str) + sizeof(message) + 4 > text_size)
+        {
+            fwrite(text, 1, used, stdout);
+            used = 0;
+        }
+        used += snprintf(text + used, text_size - used, "[%s] %s\n", time_str, message);
+    }
+    fwrite(text, 1, used, stdout);
+    fflush(stdout);
+    sem_post(&runway_system.console_access);
+    return count;
+}
+
+// Consumer thread: flush every LOG_FLUSH_INTERVAL_MS until stopped and drained
+static void *logger_thread(void *arg)
+{
+    Logger *lg = (Logger *)arg;
+    LogRecord *batch = (LogRecord *)malloc(LOG_BATCH_SIZE * sizeof(LogRecord));
+    size_t text_size = 64 * 1024;
+    char *text = (char *)malloc(text_size);
+    if (batch == NULL || text == NULL)
+    {
+        perror("Failed to allocate log buffers");
+        exit(1);
+    }
+
+    while (1)
+    {
+        int flushed = logger_flush(lg, batch, text, text_size);
+        if (flushed == LOG_BATCH_SIZE || (atomic_load(&lg->stop) && flushed > 0))
+            continue; // Still behind, keep draining
+        if (atomic_load(&lg->stop))
+            break;
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += LOG_FLUSH_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (sem_timedwait(&lg->wakeup_sem, &deadline) != 0 && errno == EINTR)
+            ;
+    }
+
+    free(batch);
+    free(text);
+    return NULL;
+}
+
+// Start the background formatter; runway_print_status buffers from now on
+void logger_start(Logger *lg)
+{
+    for (int i = 0; i < LOG_MAX_RINGS; i++)
+    {
+        atomic_init(&lg->rings[i].owned, 0);
+        atomic_init(&lg->rings[i].head, 0);
+        atomic_init(&lg->rings[i].tail, 0);
+        lg->rings[i].records = NULL;
+    }
+    atomic_init(&lg->ring_count, 0);
+    atomic_init(&lg->written, 0);
+    atomic_init(&lg->dropped, 0);
+    atomic_init(&lg->fallbacks, 0);
+    sem_init(&lg->wakeup_sem, 0, 0); // Counting semaphore (initially 0)
+    atomic_init(&lg->stop, 0);
+
+    if (pthread_create(&lg->thread, NULL, logger_thread, lg) != 0)
+    {
+        perror("Failed to create logger thread");
+        exit(1);
+    }
+    logger_enabled = 1;
+}
+
+// Block until the consumer has emptied every ring (e.g. before final statistics)
+void logger_drain(Logger *lg)
+{
+    struct timespec pause = {0, 1000000L}; // 1ms
+    int rings = atomic_load(&lg->ring_count);
+    for (int i = 0; i < rings; i++)
+    {
+        LogRing *ring = &lg->rings[i];
+        while (atomic_load(&ring->tail) != atomic_load(&ring->head))
+        {
+            sem_post(&lg->wakeup_sem);
+            nanosleep(&pause, NULL);
+        }
+    }
+}
+
+// Drain all rings, stop the formatter and report overflow
+void logger_stop(Logger *lg)
+{
+    logger_thread_release(lg);
+    atomic_store(&lg->stop, 1);
+    sem_post(&lg->wakeup_sem);
+    pthread_join(lg->thread, NULL);
+    logger_enabled = 0;
+
+    printf("[LOG] %ld records written asynchronously, %ld dropped on ring overflow, %ld printed synchronously\n",
+           atomic_load(&lg->written), atomic_load(&lg->dropped), atomic_load(&lg->fallbacks));
+
+    for (int i = 0; i < LOG_MAX_RINGS; i++)
+    {
+        free(lg->rings[i].records);
+        lg->rings[i].records = NULL;
+    }
+    sem_destroy(&lg->wakeup_sem);
+}
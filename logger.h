@@ -0,0 +1,66 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+
+#define LOG_MAX_RINGS 256     // Producer threads that can hold a ring at once
+#define LOG_RING_SIZE 4096    // Records per ring (power of two)
+#define LOG_MAX_ARGS 6        // Arguments captured per record
+#define LOG_BATCH_SIZE 1024   // Records formatted per flush
+#define LOG_FLUSH_INTERVAL_MS 50
+
+// One captured printf argument
+typedef union
+{
+    long long i;
+    double d;
+    const char *s; // Must point at a string that outlives the record (literals)
+} LogArg;
+
+// Fixed-size binary log record; the format literal doubles as the event code
+typedef struct
+{
+    long long stamp_ns;  // Wall clock, or simulated clock in virtual-time mode
+    unsigned long seq;   // Position in the producer's ring
+    const char *format;
+    int arg_count;
+    LogArg args[LOG_MAX_ARGS];
+} LogRecord;
+
+// Single-producer/single-consumer ring owned by one thread at a time
+typedef struct
+{
+    atomic_int owned;       // Claimed by a producer thread
+    atomic_ulong head;      // Next slot the producer writes
+    atomic_ulong tail;      // Next slot the consumer reads
+    LogRecord *records;     // Allocated on first claim
+} LogRing;
+
+// Asynchronous logger: producers fill per-thread rings, one thread formats and flushes
+typedef struct
+{
+    LogRing rings[LOG_MAX_RINGS];
+    atomic_int ring_count;  // Rings ever claimed (consumer scans this many)
+    atomic_long written;
+    atomic_long dropped;    // Records lost because a ring was full
+    atomic_long fallbacks;  // Records printed synchronously (no ring or too many args)
+    pthread_t thread;
+    sem_t wakeup_sem;       // Counting semaphore: ring half full or shutdown
+    atomic_int stop;        // Set by logger_stop(); polled by the consumer thread
+} Logger;
+
+// Global logger instance
+extern Logger logger;
+extern int logger_enabled;
+
+// Logger functions
+void logger_start(Logger *lg);
+int logger_vwrite(Logger *lg, long long stamp_ns, const char *format, va_list args);
+void logger_thread_release(Logger *lg);
+void logger_drain(Logger *lg);
+void logger_stop(Logger *lg);
+
+#endif // LOGGER_H
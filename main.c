@@ -1,27 +1,31 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include "runway.h"
 #include "plane.h"
 #include "gui.h"
+#include "sim.h"
+#include "engine.h"
+#include "pool.h"
+#include "logger.h"
+#include "trace.h"
+#include "workload.h"
+#include "sweep.h"
+#include "snapshot.h"
+#include "eventlog.h"
+#include "metrics.h"
+#include "sequence.h"
+#include "policy.h"
+#include "bus.h"
+#include "affinity.h"
 
 #define DEFAULT_TOTAL_PLANES 10
 #define DEFAULT_EMERGENCY_PROBABILITY 15 // 15%
 #define DEFAULT_LANDING_DURATION 8       // 8 seconds for better visualization
 #define DEFAULT_TAKEOFF_DURATION 6       // 6 seconds for better visualization
-
-// Function to generate random operation type
-OperationType random_operation()
-{
-    return (rand() % 2 == 0) ? LANDING : TAKEOFF;
-}
-
-// Function to determine if plane is emergency based on probability
-PriorityLevel random_priority(int emergency_prob)
-{
-    return (rand() % 100 < emergency_prob) ? EMERGENCY : NORMAL;
-}
+#define DEFAULT_LANDING_MIX 50           // 50% landings
 
 // Display usage information
 void print_usage(const char *program_name)
@@ -34,13 +38,137 @@ void print_usage(const char *program_name)
     printf("  -e <percent>   Emergency probability 0-100 (default: %d%%)\n", DEFAULT_EMERGENCY_PROBABILITY);
     printf("  -l <seconds>   Landing duration (default: %d seconds)\n", DEFAULT_LANDING_DURATION);
     printf("  -t <seconds>   Takeoff duration (default: %d seconds)\n", DEFAULT_TAKEOFF_DURATION);
+    printf("  -s <seed>      Random seed for generated traffic (default: time and pid)\n");
+    printf("  -W <pattern>   Arrival pattern: uniform, poisson, rush or storm (default: uniform)\n");
+    printf("  -M <percent>   Share of generated flights that land, 0-100 (default: %d%%)\n", DEFAULT_LANDING_MIX);
     printf("  -g             Enable GUI mode (ncurses visualization)\n");
+    printf("  -F <fps>       GUI frame rate (default: %d)\n", GUI_DEFAULT_FRAME_RATE);
+    printf("  -V             Virtual-time mode (discrete-event simulation, no real delays)\n");
+    printf("  -w <workers>   Event-driven engine with a fixed worker pool (no thread per plane)\n");
+    printf("  -f <file>      Replay a flight schedule (arrival,operation,class[,duration]); ignores -n/-e/-s/-W/-M\n");
+    printf("  -r <n>[:roles] Number of runways, optional roles per runway (L/T/M, default all M)\n");
+    printf("  -x <sec>:<file> Write a snapshot when the simulated clock reaches <sec> (needs -V)\n");
+    printf("  -X <file>      Resume a snapshot on the virtual clock; -l/-t and -s/-e/-W/-M apply from there on\n");
+    printf("  -S             Parameter sweep: ranges for -n/-e/-l/-t, parallel runs, CSV output (-S -h)\n");
+    printf("  -E <file>      Record scheduling events to a compact binary log (read with runway_eventlog)\n");
+    printf("  -P <address>   Serve Prometheus metrics on a Unix socket path or localhost [host:]port\n");
+    printf("  -A             Asynchronous logging (ring buffers drained by a logger thread)\n");
+    printf("  -p <policy>    Scheduling policy: %s (default: %s)\n", policy_names(), POLICY_DEFAULT->name);
+    printf("  -a <ms>        Aging policy; waiting <ms> ages a plane one class (0 = no aging, default: %d)\n",
+           POLICY_DEFAULT_AGING_MS);
+    printf("  -q <n>[:<k>]   Sequence the first <n> normal planes for least total completion time;\n");
+    printf("                 a plane waits behind at most <k> later arrivals (default k: %d)\n", SEQUENCE_DEFAULT_SHIFT);
+    printf("  -G <LL,LT,TL,TT> Separation seconds between leader/follower operations (default: all 0)\n");
+    printf("  -C <cpus>      Pin the dispatcher, engine workers and plane threads to CPUs, e.g. 2-3,6\n");
+    printf("  -R <policy>[:<prio>] Real-time priority for those threads: fifo or rr (default prio: %d)\n",
+           AFFINITY_DEFAULT_PRIORITY);
     printf("  -h             Display this help message\n\n");
     printf("Example:\n");
     printf("  %s -n 20 -e 20 -l 6 -t 4\n", program_name);
     printf("  (Simulate 20 planes with 20%% emergency, 6s landing, 4s takeoff)\n\n");
 }
 
+// Classic mode: one thread per plane, spawned at each flight's arrival time
+int run_plane_threads(Workload *workload, int use_gui)
+{
+    // Plane handles; each plane is taken from the pool when it arrives
+    int total_planes = workload->total_planes;
+    int capacity = (workload->trace != NULL) ? 64 : total_planes;
+    Plane **planes = (Plane **)malloc(capacity * sizeof(Plane *));
+    if (planes == NULL)
+    {
+        fprintf(stderr, "Error: Failed to allocate memory for planes\n");
+        return 1;
+    }
+
+    if (!use_gui)
+    {
+        printf("[SETUP] Starting simulation with %d planes...\n\n", total_planes);
+        sleep(1);
+    }
+    else
+    {
+        gui_log_event("[SETUP] Starting simulation with %d planes...", total_planes);
+        gui_refresh_all();
+        sleep(1);
+    }
+
+    // Start the central dispatcher before any plane can queue
+    runway_start_dispatcher(&runway_system);
+
+    // Spawn plane threads at their arrival times. Flights that are due
+    // together are admitted as one batch before their threads start.
+    long long start_ms = sim_now_ms();
+    TraceFlight flight;
+    int have_flight = workload_next(workload, &flight);
+    int spawned = 0;
+    while (have_flight)
+    {
+        // Wait for the flight's arrival
+        long long delay_ms = start_ms + flight.arrival_ms - sim_now_ms();
+        if (delay_ms > 0)
+            usleep(delay_ms * 1000);
+
+        int batch_start = spawned;
+        do
+        {
+            if (spawned == capacity)
+            {
+                capacity *= 2;
+                Plane **grown = (Plane **)realloc(planes, capacity * sizeof(Plane *));
+                if (grown == NULL)
+                {
+                    fprintf(stderr, "Error: Failed to allocate memory for planes\n");
+                    return 1;
+                }
+                planes = grown;
+            }
+
+            planes[spawned] = (Plane *)pool_alloc(&plane_pool);
+            if (planes[spawned] == NULL)
+            {
+                fprintf(stderr, "Error: Failed to allocate plane %d\n", spawned + 1);
+                return 1;
+            }
+            trace_plane_init(planes[spawned], spawned + 1, &flight);
+            spawned++;
+            have_flight = workload_next(workload, &flight);
+        } while (have_flight && start_ms + flight.arrival_ms <= sim_now_ms());
+        if (workload->trace != NULL)
+            runway_system.total_planes = spawned;
+
+        runway_admit_batch(&runway_system, planes + batch_start, spawned - batch_start);
+        for (int i = batch_start; i < spawned; i++)
+        {
+            if (pthread_create(&planes[i]->cold->thread, NULL, plane_thread_function, planes[i]) != 0)
+            {
+                fprintf(stderr, "Error: Failed to create thread for plane %d\n", i + 1);
+                return 1;
+            }
+        }
+    }
+
+    // Wait for all planes to complete
+    if (!use_gui)
+    {
+        printf("\n[SYSTEM] Waiting for all planes to complete...\n\n");
+    }
+    else
+    {
+        gui_log_event("[SYSTEM] Waiting for all planes to complete...");
+    }
+    for (int i = 0; i < spawned; i++)
+    {
+        pthread_join(planes[i]->cold->thread, NULL);
+        plane_destroy(planes[i]);
+        pool_free(&plane_pool, planes[i]);
+    }
+    runway_stop_dispatcher(&runway_system);
+
+    free(planes);
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     // Default parameters
@@ -49,10 +177,46 @@ int main(int argc, char *argv[])
     int landing_duration = DEFAULT_LANDING_DURATION;
     int takeoff_duration = DEFAULT_TAKEOFF_DURATION;
     int use_gui = 0;
+    int frame_rate = GUI_DEFAULT_FRAME_RATE;
+    int virtual_time = 0;
+    int engine_workers = 0;
+    long long aging_ms = -1;
+    const SchedPolicy *policy = NULL;
+    int runway_count = 1;
+    int async_log = 0;
+    const char *runway_roles = NULL;
+    const char *trace_path = NULL;
+    Trace trace;
+    uint64_t seed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+    WorkloadPattern pattern = WORKLOAD_UNIFORM;
+    int landing_mix = DEFAULT_LANDING_MIX;
+    Workload workload;
+    long long snapshot_at_ms = -1;
+    const char *snapshot_path = NULL;
+    const char *restore_path = NULL;
+    const char *event_log_path = NULL;
+    const char *metrics_address = NULL;
+    int sequence_window = -1;
+    int sequence_shift = SEQUENCE_DEFAULT_SHIFT;
+    int separation[2][2];
+    int separation_set = 0;
+    int landing_set = 0;
+    int takeoff_set = 0;
+    int traffic_set = 0; // -s/-e/-W/-M given: re-generate restored traffic
+    char *end;
+
+    // Sweep mode takes ranges instead of single values and has its own parser
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-S") == 0)
+        {
+            return sweep_main(argc, argv);
+        }
+    }
 
     // Parse command-line arguments
     int opt;
-    while ((opt = getopt(argc, argv, "n:e:l:t:gh")) != -1)
+    while ((opt = getopt(argc, argv, "n:e:l:t:s:W:M:gF:Vw:p:a:q:G:r:f:x:X:E:P:C:R:Ah")) != -1)
     {
         switch (opt)
         {
@@ -71,6 +235,7 @@ int main(int argc, char *argv[])
                 fprintf(stderr, "Error: Emergency probability must be between 0 and 100\n");
                 return 1;
             }
+            traffic_set = 1;
             break;
         case 'l':
             landing_duration = atoi(optarg);
@@ -79,6 +244,7 @@ int main(int argc, char *argv[])
                 fprintf(stderr, "Error: Landing duration must be positive\n");
                 return 1;
             }
+            landing_set = 1;
             break;
         case 't':
             takeoff_duration = atoi(optarg);
@@ -87,10 +253,147 @@ int main(int argc, char *argv[])
                 fprintf(stderr, "Error: Takeoff duration must be positive\n");
                 return 1;
             }
+            takeoff_set = 1;
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 0);
+            traffic_set = 1;
+            break;
+        case 'W':
+            if (workload_parse_pattern(optarg, &pattern) != 0)
+            {
+                fprintf(stderr, "Error: Arrival pattern must be uniform, poisson, rush or storm\n");
+                return 1;
+            }
+            traffic_set = 1;
+            break;
+        case 'M':
+            landing_mix = atoi(optarg);
+            if (landing_mix < 0 || landing_mix > 100)
+            {
+                fprintf(stderr, "Error: Landing mix must be between 0 and 100\n");
+                return 1;
+            }
+            traffic_set = 1;
             break;
         case 'g':
             use_gui = 1;
             break;
+        case 'F':
+            frame_rate = atoi(optarg);
+            if (frame_rate <= 0 || frame_rate > 120)
+            {
+                fprintf(stderr, "Error: Frame rate must be between 1 and 120\n");
+                return 1;
+            }
+            break;
+        case 'V':
+            virtual_time = 1;
+            break;
+        case 'w':
+            engine_workers = atoi(optarg);
+            if (engine_workers <= 0 || engine_workers > ENGINE_MAX_WORKERS)
+            {
+                fprintf(stderr, "Error: Worker count must be between 1 and %d\n", ENGINE_MAX_WORKERS);
+                return 1;
+            }
+            break;
+        case 'r':
+            runway_count = atoi(optarg);
+            runway_roles = strchr(optarg, ':');
+            if (runway_roles != NULL)
+            {
+                runway_roles++;
+            }
+            if (runway_count <= 0 || runway_count > MAX_RUNWAYS)
+            {
+                fprintf(stderr, "Error: Runway count must be between 1 and %d\n", MAX_RUNWAYS);
+                return 1;
+            }
+            break;
+        case 'A':
+            async_log = 1;
+            break;
+        case 'f':
+            trace_path = optarg;
+            break;
+        case 'x':
+            snapshot_at_ms = (long long)(strtod(optarg, &end) * 1000);
+            if (*end != ':' || end[1] == '\0' || snapshot_at_ms < 0)
+            {
+                fprintf(stderr, "Error: Snapshot must be given as <seconds>:<file>\n");
+                return 1;
+            }
+            snapshot_path = end + 1;
+            break;
+        case 'X':
+            restore_path = optarg;
+            virtual_time = 1;
+            break;
+        case 'E':
+            event_log_path = optarg;
+            break;
+        case 'P':
+            metrics_address = optarg;
+            break;
+        case 'p':
+            policy = policy_find(optarg);
+            if (policy == NULL)
+            {
+                fprintf(stderr, "Error: Unknown scheduling policy %s (available: %s)\n", optarg, policy_names());
+                return 1;
+            }
+            break;
+        case 'a':
+            aging_ms = atoll(optarg);
+            if (aging_ms < 0)
+            {
+                fprintf(stderr, "Error: Aging interval must be zero or positive\n");
+                return 1;
+            }
+            break;
+        case 'q':
+            sequence_window = (int)strtol(optarg, &end, 10);
+            if (*end == ':')
+            {
+                sequence_shift = (int)strtol(end + 1, &end, 10);
+            }
+            if (*end != '\0' || sequence_window < 0 || sequence_window > SEQUENCE_MAX_WINDOW || sequence_shift < 0)
+            {
+                fprintf(stderr, "Error: Sequencing must be given as <window 0-%d>[:<shift>]\n", SEQUENCE_MAX_WINDOW);
+                return 1;
+            }
+            break;
+        case 'G':
+            if (sscanf(optarg, "%d,%d,%d,%d", &separation[LANDING][LANDING], &separation[LANDING][TAKEOFF],
+                       &separation[TAKEOFF][LANDING], &separation[TAKEOFF][TAKEOFF]) != 4 ||
+                separation[LANDING][LANDING] < 0 || separation[LANDING][TAKEOFF] < 0 ||
+                separation[TAKEOFF][LANDING] < 0 || separation[TAKEOFF][TAKEOFF] < 0)
+            {
+                fprintf(stderr, "Error: Separation must be four seconds values: LL,LT,TL,TT\n");
+                return 1;
+            }
+            separation_set = 1;
+            break;
+        case 'C':
+            if (affinity_set_cpus(&affinity, optarg) != 0)
+            {
+                fprintf(stderr, "Error: CPU list must be CPU numbers and ranges, e.g. 0,2-3\n");
+                return 1;
+            }
+            break;
+        case 'R':
+            if (affinity_set_realtime(&affinity, optarg) != 0)
+            {
+                int rt_policy = affinity_realtime_policy(optarg);
+                if (rt_policy < 0)
+                    fprintf(stderr, "Error: Real-time priority must be fifo[:<prio>] or rr[:<prio>]\n");
+                else
+                    fprintf(stderr, "Error: %s priority must be %d-%d\n", rt_policy == SCHED_FIFO ? "fifo" : "rr",
+                            sched_get_priority_min(rt_policy), sched_get_priority_max(rt_policy));
+                return 1;
+            }
+            break;
         case 'h':
             print_usage(argv[0]);
             return 0;
@@ -100,13 +403,80 @@ int main(int argc, char *argv[])
         }
     }
 
-    // Seed random number generator
-    srand(time(NULL));
+#ifdef BUS_DISABLED
+    if (use_gui)
+    {
+        fprintf(stderr, "Error: GUI mode needs the event bus (rebuild without BUS=off)\n");
+        return 1;
+    }
+#endif
+    if (use_gui && virtual_time)
+    {
+        fprintf(stderr, "Error: GUI mode cannot be combined with virtual-time mode\n");
+        return 1;
+    }
+    if (snapshot_path != NULL && !virtual_time)
+    {
+        fprintf(stderr, "Error: Snapshots are taken on the virtual clock (use -V)\n");
+        return 1;
+    }
+    if ((snapshot_path != NULL || restore_path != NULL) && trace_path != NULL)
+    {
+        fprintf(stderr, "Error: Snapshots cover generated traffic and cannot be combined with -f\n");
+        return 1;
+    }
+    if (aging_ms >= 0)
+    {
+        if (policy == NULL)
+            policy = policy_find("aging");
+        if (policy != &policy_aging)
+        {
+            fprintf(stderr, "Error: -a sets the aging interval of the aging policy (available: %s)\n", policy_names());
+            return 1;
+        }
+    }
+    if (restore_path != NULL && policy != NULL)
+    {
+        fprintf(stderr, "Error: A restored snapshot keeps its scheduling policy (drop -p/-a)\n");
+        return 1;
+    }
+    if (restore_path == NULL && policy == NULL)
+    {
+        policy = POLICY_DEFAULT;
+    }
+    if (sequence_window > 1 && policy != NULL && policy != &policy_fcfs)
+    {
+        fprintf(stderr, "Error: Sequencing reorders normal_queue and only applies to the fcfs policy\n");
+        return 1;
+    }
+    if (policy == &policy_aging && aging_ms < 0)
+    {
+        aging_ms = POLICY_DEFAULT_AGING_MS;
+    }
+    if (virtual_time && engine_workers > 0)
+    {
+        fprintf(stderr, "Error: Virtual-time mode runs on a single thread and cannot use -w\n");
+        return 1;
+    }
+
+    // Map the flight schedule before anything takes over the terminal
+    if (trace_path != NULL && trace_open(&trace, trace_path) != 0)
+    {
+        fprintf(stderr, "Error: Cannot open trace file %s\n", trace_path);
+        return 1;
+    }
+
+    // Generated traffic is fully determined by the seed
+    workload_init(&workload, pattern, total_planes, emergency_prob, landing_mix, seed);
+    if (trace_path != NULL)
+    {
+        workload_set_trace(&workload, &trace);
+    }
 
     // Initialize GUI if requested
     if (use_gui)
     {
-        gui_init();
+        gui_init(frame_rate);
         usleep(500000); // Give GUI time to initialize
     }
 
@@ -119,82 +489,247 @@ int main(int argc, char *argv[])
         printf("╚══════════════════════════════════════════════════════════╝\n");
         printf("\n");
         printf("Simulation Parameters:\n");
-        printf("  • Total Planes: %d\n", total_planes);
-        printf("  • Emergency Probability: %d%%\n", emergency_prob);
+        if (trace_path != NULL)
+        {
+            printf("  • Traffic: replaying %s\n", trace_path);
+        }
+        else if (restore_path != NULL)
+        {
+            printf("  • Traffic: restored from %s%s\n", restore_path,
+                   traffic_set ? ", re-generated from the restore point" : "");
+        }
+        else
+        {
+            printf("  • Total Planes: %d\n", total_planes);
+            printf("  • Emergency Probability: %d%%\n", emergency_prob);
+            printf("  • Arrivals: %s, %d%% landings (seed: %llu)\n",
+                   workload_pattern_to_string(pattern), landing_mix, (unsigned long long)seed);
+        }
         printf("  • Landing Duration: %d seconds\n", landing_duration);
         printf("  • Takeoff Duration: %d seconds\n", takeoff_duration);
-        printf("  • Checkpoint Interval: 500ms (for preemption checks)\n");
+        printf("  • Checkpoint Interval: %dms (for preemption checks)\n", CHECKPOINT_INTERVAL_MS);
+        if (virtual_time)
+        {
+            printf("  • Clock: virtual (discrete-event simulation)\n");
+        }
+        if (runway_roles != NULL)
+        {
+            printf("  • Runways: %d (roles: %s)\n", runway_count, runway_roles);
+        }
+        else
+        {
+            printf("  • Runways: %d\n", runway_count);
+        }
+        if (policy == &policy_aging)
+        {
+            printf("  • Scheduling: aging, %s (aging: %lldms per class)\n", policy->description, aging_ms);
+        }
+        else if (policy != NULL && policy != &policy_fcfs)
+        {
+            printf("  • Scheduling: %s, %s\n", policy->name, policy->description);
+        }
+        if (sequence_window > 1)
+        {
+            printf("  • Sequencing: first %d normal planes, at most %d later arrivals ahead\n",
+                   sequence_window, sequence_shift);
+        }
+        if (separation_set)
+        {
+            printf("  • Separation: L->L %ds, L->T %ds, T->L %ds, T->T %ds\n",
+                   separation[LANDING][LANDING], separation[LANDING][TAKEOFF],
+                   separation[TAKEOFF][LANDING], separation[TAKEOFF][TAKEOFF]);
+        }
+        if (affinity_enabled(&affinity))
+        {
+            char placement[256];
+            affinity_describe(&affinity, placement, sizeof(placement));
+            printf("  • Threads: %s\n", placement);
+        }
+        if (async_log)
+        {
+            printf("  • Logging: asynchronous (%d records per thread ring)\n", LOG_RING_SIZE);
+        }
+        if (engine_workers > 0)
+        {
+            printf("  • Engine: event-driven, %d worker threads\n", engine_workers);
+        }
+        if (event_log_path != NULL)
+        {
+            printf("  • Event log: %s\n", event_log_path);
+        }
+        if (metrics_address != NULL)
+        {
+            printf("  • Metrics: Prometheus text on %s\n", metrics_address);
+        }
         printf("\n");
         printf("═══════════════════════════════════════════════════════════\n\n");
     }
 
-    // Initialize runway system
-    runway_init(&runway_system, landing_duration, takeoff_duration);
-    runway_system.total_planes = total_planes;
+    // Object pools for planes (hot records plus side table) and queue nodes (no heap traffic once warm)
+    pool_init(&plane_pool, "plane", sizeof(Plane));
+    pool_init(&plane_cold_pool, "plane-cold", sizeof(PlaneCold));
+    pool_init(&queue_node_pool, "queue-node", sizeof(QueueNode));
 
-    // Allocate array for planes
-    Plane *planes = (Plane *)malloc(total_planes * sizeof(Plane));
-    if (planes == NULL)
+    // Hand log formatting and output to a background thread
+    if (async_log)
     {
-        fprintf(stderr, "Error: Failed to allocate memory for planes\n");
-        return 1;
+        logger_start(&logger);
     }
 
-    // Create and initialize planes
-    if (!use_gui)
+    // Lifecycle lines reach the console through the event bus (the GUI subscribes in gui_start).
+    // On the virtual clock the log is the result and the single thread has no one to keep
+    // waiting, so it waits for the console; with real threads a full ring drops lines instead.
+#ifndef BUS_DISABLED
+    if (!use_gui && bus_subscribe(&event_bus, "console", BUS_ALL_EVENTS & ~(1u << BUS_CHECKPOINT),
+                                  virtual_time ? BUS_BLOCK_WHEN_FULL : BUS_DROP_WHEN_FULL,
+                                  bus_console_handler, NULL) != 0)
     {
-        printf("[SETUP] Creating %d planes...\n", total_planes);
+        return 1;
     }
-    else
+#endif
+
+    // Binary event log, written by its own thread in large blocks
+    if (event_log_path != NULL && eventlog_open(&event_log, event_log_path) != 0)
     {
-        gui_log_event("[SETUP] Creating %d planes...", total_planes);
+        return 1;
     }
-    for (int i = 0; i < total_planes; i++)
+
+    // Lines printed while setting up are stamped on the clock of the run
+    if (virtual_time)
     {
-        OperationType op = random_operation();
-        PriorityLevel priority = random_priority(emergency_prob);
-        plane_init(&planes[i], i + 1, op, priority);
+        sim_virtual_mode = 1;
     }
 
-    if (!use_gui)
+    if (restore_path != NULL)
     {
-        printf("[SETUP] All planes created. Starting simulation...\n\n");
-        sleep(1);
+        // The snapshot brings its runways, queues, counters and traffic; what-if
+        // options override them from the restore point on
+        if (snapshot_restore(restore_path, &workload) != 0)
+        {
+            return 1;
+        }
+        if (landing_set)
+        {
+            runway_system.config.landing_duration = landing_duration;
+        }
+        if (takeoff_set)
+        {
+            runway_system.config.takeoff_duration = takeoff_duration;
+        }
+        if (traffic_set)
+        {
+            workload_fork(&workload, pattern, emergency_prob, landing_mix, seed);
+        }
     }
     else
     {
-        gui_log_event("[SETUP] All planes created. Starting simulation...");
-        gui_refresh_all();
-        sleep(1);
+        // Initialize runway system
+        runway_init(&runway_system, landing_duration, takeoff_duration);
+        runway_system.total_planes = (trace_path != NULL) ? 0 : total_planes;
+        sim_set_workload(&workload);
+        if (runway_configure(&runway_system, runway_count, runway_roles) != 0)
+        {
+            fprintf(stderr, "Error: Invalid runway roles (use L, T or M; landings and takeoffs both need a runway)\n");
+            return 1;
+        }
+        if (policy == &policy_aging)
+        {
+            runway_enable_priority_heap(&runway_system, aging_ms);
+        }
+        else
+        {
+            runway_set_policy(&runway_system, policy);
+        }
     }
 
-    // Spawn plane threads with staggered arrival
-    for (int i = 0; i < total_planes; i++)
+    // Sequencing and separation also override a restored snapshot's settings
+    if (separation_set)
+    {
+        memcpy(runway_system.config.separation, separation, sizeof(separation));
+    }
+    if (sequence_window >= 0)
     {
-        if (pthread_create(&planes[i].thread, NULL, plane_thread_function, &planes[i]) != 0)
+        if (sequence_window > 1 && runway_system.policy != &policy_fcfs)
         {
-            fprintf(stderr, "Error: Failed to create thread for plane %d\n", i + 1);
+            fprintf(stderr, "Error: The snapshot uses the %s policy, which cannot be sequenced\n",
+                    runway_system.policy->name);
             return 1;
         }
+        runway_enable_sequencing(&runway_system, sequence_window, sequence_shift);
+    }
 
-        // Stagger arrivals for better visualization (1-3 seconds between planes)
-        usleep((rand() % 2000 + 1000) * 1000); // 1s to 3s
+    // Scrapes read the runway table's published state, so serve after it exists
+    if (metrics_address != NULL && metrics_start(&metrics_server, metrics_address) != 0)
+    {
+        return 1;
     }
 
-    // Wait for all planes to complete
-    if (!use_gui)
+    // Panels read the runway table, so the renderer starts after it exists
+    if (use_gui)
     {
-        printf("\n[SYSTEM] Waiting for all planes to complete...\n\n");
+        gui_start();
     }
-    else
+
+    // Virtual-time mode: arrivals and checkpoints are events on a simulated clock
+    if (virtual_time)
     {
-        gui_log_event("[SYSTEM] Waiting for all planes to complete...");
+        // The loop is the dispatcher; observer threads already exist and keep their placement
+        affinity_apply(&affinity, AFFINITY_DISPATCHER);
+        if (snapshot_path != NULL)
+        {
+            sim_set_snapshot(snapshot_at_ms, snapshot_path);
+        }
+        if (restore_path != NULL)
+        {
+            sim_resume();
+        }
+        else
+        {
+            sim_run();
+        }
+        bus_stop(&event_bus);
+        eventlog_close(&event_log);
+
+        printf("\n");
+        runway_display_stats();
+        affinity_report(&affinity);
+        if (trace_path != NULL)
+        {
+            runway_print_status("[TRACE] %ld flights replayed, %ld malformed lines skipped",
+                                trace.flights, trace.skipped);
+            trace_close(&trace);
+        }
+        if (metrics_address != NULL)
+        {
+            metrics_stop(&metrics_server);
+        }
+        runway_destroy(&runway_system);
+        if (async_log)
+        {
+            logger_stop(&logger);
+        }
+        pool_destroy(&queue_node_pool);
+        pool_destroy(&plane_pool);
+        pool_destroy(&plane_cold_pool);
+        printf("Simulation completed successfully!\n\n");
+        return 0;
+    }
+
+    if (engine_workers > 0)
+    {
+        // Event-driven engine: planes are state machines on a worker pool
+        engine_init(&engine, engine_workers);
+        engine_run(&engine);
+        engine_destroy(&engine);
     }
-    for (int i = 0; i < total_planes; i++)
+    else
     {
-        pthread_join(planes[i].thread, NULL);
-        plane_destroy(&planes[i]);
+        if (run_plane_threads(&workload, use_gui) != 0)
+        {
+            return 1;
+        }
     }
+    bus_stop(&event_bus);
 
     // Display final statistics
     if (!use_gui)
@@ -220,10 +755,28 @@ int main(int argc, char *argv[])
         printf("\n");
         runway_display_stats();
     }
+    eventlog_close(&event_log);
+    affinity_report(&affinity);
 
     // Cleanup
+    if (trace_path != NULL)
+    {
+        runway_print_status("[TRACE] %ld flights replayed, %ld malformed lines skipped",
+                            trace.flights, trace.skipped);
+        trace_close(&trace);
+    }
+    if (metrics_address != NULL)
+    {
+        metrics_stop(&metrics_server);
+    }
     runway_destroy(&runway_system);
-    free(planes);
+    if (async_log)
+    {
+        logger_stop(&logger);
+    }
+    pool_destroy(&queue_node_pool);
+    pool_destroy(&plane_pool);
+    pool_destroy(&plane_cold_pool);
 
     if (!use_gui)
     {
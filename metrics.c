@@ -0,0 +1,261 @@
+#define _DEFAULT_SOURCE // sockets, poll
+#include "metrics.h"
+#include "runway.h"
+#include "stats.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// Global metrics server instance
+MetricsServer metrics_server;
+
+// Wait percentiles exported per queue
+static const double metrics_quantiles[] = {0.5, 0.9, 0.99};
+
+// Append formatted text to the response buffer
+static void metrics_printf(char *buffer, int size, int *length, const char *format, ...)
+{
+    if (*length >= size)
+        return;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer + *length, size - *length, format, args);
+    va_end(args);
+    *length = (n < 0) ? size : *length + n;
+}
+
+// Render every metric in Prometheus text format; returns the length
+int metrics_render(MetricsServer *server, char *buffer, int size)
+{
+    RunwaySystem *sys = &runway_system;
+    int length = 0;
+
+    metrics_printf(buffer, size, &length,
+                   "# HELP runway_queue_depth Planes waiting for a runway.\n"
+                   "# TYPE runway_queue_depth gauge\n"
+                   "runway_queue_depth{queue=\"emergency_queue\"} %ld\n"
+                   "runway_queue_depth{queue=\"normal_queue\"} %ld\n",
+                   stats_read(&runway_stats, STAT_QUEUED_EMERGENCY),
+                   stats_read(&runway_stats, STAT_QUEUED_NORMAL));
+
+    metrics_printf(buffer, size, &length,
+                   "# HELP runway_active_plane Id of the plane holding each runway (-1 when idle).\n"
+                   "# TYPE runway_active_plane gauge\n");
+    for (int i = 0; i < sys->runway_count; i++)
+    {
+        Runway *runway = &sys->runways[i];
+        metrics_printf(buffer, size, &length, "runway_active_plane{runway=\"%d\",role=\"%s\"} %d\n",
+                       runway->id, runway_role_to_string(runway->role),
+                       atomic_load_explicit(&runway->active_plane_id, memory_order_relaxed));
+    }
+
+    // Throughput over the simulated time since the previous scrape
+    long completed = stats_read(&runway_stats, STAT_PLANES_COMPLETED);
+    long long now_ms = sim_now_ms();
+    long long since_ms = (server->scrapes > 0) ? server->last_scrape_ms : sys->start_ms;
+    double rate = (now_ms > since_ms) ? (completed - server->last_completed) * 1000.0 / (now_ms - since_ms) : 0.0;
+    server->last_completed = completed;
+    server->last_scrape_ms = now_ms;
+    server->scrapes++;
+    metrics_printf(buffer, size, &length,
+                   "# HELP runway_planes_completed_total Planes that finished their operation.\n"
+                   "# TYPE runway_planes_completed_total counter\n"
+                   "runway_planes_completed_total %ld\n"
+                   "# HELP runway_completions_per_second Completions per simulated second since the previous scrape.\n"
+                   "# TYPE runway_completions_per_second gauge\n"
+                   "runway_completions_per_second %.3f\n",
+                   completed, rate);
+
+    metrics_printf(buffer, size, &length,
+                   "# HELP runway_preemptions_total Normal planes preempted by an emergency.\n"
+                   "# TYPE runway_preemptions_total counter\n"
+                   "runway_preemptions_total %ld\n",
+                   stats_read(&runway_stats, STAT_PREEMPTIONS));
+
+    metrics_printf(buffer, size, &length,
+                   "# HELP runway_wait_seconds Queue wait before the first runway grant.\n"
+                   "# TYPE runway_wait_seconds summary\n");
+    for (int emergency = 1; emergency >= 0; emergency--)
+    {
+        const char *queue = emergency ? "emergency_queue" : "normal_queue";
+        for (size_t q = 0; q < sizeof(metrics_quantiles) / sizeof(metrics_quantiles[0]); q++)
+        {
+            long long wait_ms = stats_wait_percentile_ms(&runway_stats, emergency, metrics_quantiles[q] * 100.0);
+            metrics_printf(buffer, size, &length, "runway_wait_seconds{queue=\"%s\",quantile=\"%g\"} %.3f\n",
+                           queue, metrics_quantiles[q], wait_ms / 1000.0);
+        }
+        metrics_printf(buffer, size, &length,
+                       "runway_wait_seconds_sum{queue=\"%s\"} %.3f\n"
+                       "runway_wait_seconds_count{queue=\"%s\"} %ld\n",
+                       queue, stats_read(&runway_stats, emergency ? STAT_WAIT_EMERGENCY_MS : STAT_WAIT_NORMAL_MS) / 1000.0,
+                       queue, stats_read(&runway_stats, emergency ? STAT_WAITS_EMERGENCY : STAT_WAITS_NORMAL));
+    }
+    return (length < size) ? length : size - 1;
+}
+
+// Write all of data; MSG_NOSIGNAL keeps a scraper that hung up from raising
+// SIGPIPE. Returns -1 once the connection fails.
+static int metrics_send(int client, const char *data, int length)
+{
+    while (length > 0)
+    {
+        ssize_t sent = send(client, data, length, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        data += sent;
+        length -= (int)sent;
+    }
+    return 0;
+}
+
+// Answer one scrape: read the request (any path), reply with the metrics
+static void metrics_serve(MetricsServer *server, int client)
+{
+    char request[1024];
+    struct pollfd pfd = {client, POLLIN, 0};
+    if (poll(&pfd, 1, 1000) <= 0 || read(client, request, sizeof(request)) <= 0)
+        return;
+
+    static char body[METRICS_RESPONSE_SIZE];
+    int length = metrics_render(server, body, sizeof(body));
+    char header[160];
+    int header_length = snprintf(header, sizeof(header),
+                                 "HTTP/1.0 200 OK\r\n"
+                                 "Content-Type: text/plain; version=0.0.4\r\n"
+                                 "Content-Length: %d\r\n\r\n",
+                                 length);
+    if (metrics_send(client, header, header_length) == 0)
+        metrics_send(client, body, length);
+}
+
+// Server thread: one scrape at a time, checking for shutdown between polls
+static void *metrics_thread(void *arg)
+{
+    MetricsServer *server = (MetricsServer *)arg;
+    while (!atomic_load(&server->stop))
+    {
+        struct pollfd pfd = {server->listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, METRICS_POLL_MS) <= 0)
+            continue;
+        int client = accept(server->listen_fd, NULL, NULL);
+        if (client < 0)
+            continue;
+        metrics_serve(server, client);
+        close(client);
+    }
+    return NULL;
+}
+
+// Listen on address: a path containing '/' is a Unix-domain socket,
+// otherwise [localhost:|127.0.0.1:]port on the loopback interface
+int metrics_start(MetricsServer *server, const char *address)
+{
+    memset(server, 0, sizeof(*server));
+    atomic_init(&server->stop, 0);
+    server->listen_fd = -1;
+
+    if (strchr(address, '/') != NULL)
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(address) >= sizeof(addr.sun_path))
+        {
+            fprintf(stderr, "Error: Metrics socket path is too long\n");
+            return -1;
+        }
+        strcpy(addr.sun_path, address);
+
+        // Replace a stale socket from an earlier run, but nothing else
+        struct stat existing;
+        if (lstat(address, &existing) == 0)
+        {
+            if (!S_ISSOCK(existing.st_mode))
+            {
+                fprintf(stderr, "Error: %s exists and is not a socket; not starting the metrics server\n",
+                        address);
+                return -1;
+            }
+            unlink(address);
+        }
+        server->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (server->listen_fd < 0 || bind(server->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            perror("Failed to bind metrics socket");
+            if (server->listen_fd >= 0)
+                close(server->listen_fd);
+            return -1;
+        }
+        strcpy(server->unix_path, address);
+    }
+    else
+    {
+        const char *port_text = address;
+        if (strncmp(address, "localhost:", 10) == 0)
+            port_text = address + 10;
+        else if (strncmp(address, "127.0.0.1:", 10) == 0)
+            port_text = address + 10;
+        char *end;
+        long port = strtol(port_text, &end, 10);
+        if (*port_text == '\0' || *end != '\0' || port < 1 || port > 65535)
+        {
+            fprintf(stderr, "Error: Metrics address must be a socket path or [localhost:]port\n");
+            return -1;
+        }
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((unsigned short)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int reuse = 1;
+        server->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (server->listen_fd >= 0)
+            setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (server->listen_fd < 0 || bind(server->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            perror("Failed to bind metrics port");
+            if (server->listen_fd >= 0)
+                close(server->listen_fd);
+            return -1;
+        }
+    }
+
+    if (listen(server->listen_fd, 8) != 0 ||
+        pthread_create(&server->thread, NULL, metrics_thread, server) != 0)
+    {
+        perror("Failed to start metrics server");
+        close(server->listen_fd);
+        server->listen_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+// Stop serving and remove the socket file
+void metrics_stop(MetricsServer *server)
+{
+    if (server->listen_fd < 0)
+        return;
+
+    atomic_store(&server->stop, 1);
+    pthread_join(server->thread, NULL);
+    close(server->listen_fd);
+    server->listen_fd = -1;
+    if (server->unix_path[0] != '\0')
+        unlink(server->unix_path);
+}
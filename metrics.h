@@ -0,0 +1,32 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define METRICS_RESPONSE_SIZE 16384
+#define METRICS_POLL_MS 200 // How often the server checks for shutdown
+
+// Prometheus text-format metrics served over a Unix-domain socket or a
+// localhost TCP port. Scrapes only read atomics (runway_stats and the
+// published runway state), never the scheduling semaphores.
+typedef struct
+{
+    int listen_fd;
+    char unix_path[108];       // Socket file to unlink on stop (empty for TCP)
+    pthread_t thread;
+    atomic_int stop;
+    long scrapes;
+    long last_completed;       // Completions at the previous scrape
+    long long last_scrape_ms;  // Simulation clock at the previous scrape
+} MetricsServer;
+
+// Global metrics server instance
+extern MetricsServer metrics_server;
+
+// Metrics functions
+int metrics_start(MetricsServer *server, const char *address);
+void metrics_stop(MetricsServer *server);
+int metrics_render(MetricsServer *server, char *buffer, int size);
+
+#endif // METRICS_H
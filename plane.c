@@ -1,23 +1,54 @@
 #include "plane.h"
 #include "runway.h"
-#include "gui.h"
+#include "bus.h"
+#include "affinity.h"
+#include "pool.h"
+#include "logger.h"
+#include "sim.h"
+#include "eventlog.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 
+_Static_assert(sizeof(Plane) == 32, "hot plane record should stay two per cache line");
+
 // Initialize a plane
 void plane_init(Plane *plane, int id, OperationType op, PriorityLevel priority)
 {
     plane->id = id;
     plane->operation = op;
     plane->priority = priority;
+    plane->priority_class = (priority == EMERGENCY) ? CLASS_MEDICAL : CLASS_SCHEDULED;
     plane->state = WAITING;
     plane->checkpoint_progress = 0;
-    plane->arrival_time = time(NULL);
-    plane->start_time = 0;
-    plane->completion_time = 0;
-    sem_init(&plane->resume_sem, 0, 0); // Initialize to 0, will be posted when can resume
+    plane->cold = (PlaneCold *)pool_alloc(&plane_cold_pool);
+    if (plane->cold == NULL)
+    {
+        fprintf(stderr, "Error: Failed to allocate plane %d\n", id);
+        exit(1);
+    }
+    plane->cold->arrival_ns = PLANE_NO_TIME;
+    plane->cold->first_grant_ns = PLANE_NO_TIME;
+    plane->cold->granted_ns = PLANE_NO_TIME;
+    plane->cold->preempted_ns = PLANE_NO_TIME;
+    plane->cold->completion_ns = PLANE_NO_TIME;
+    plane->cold->service_ns = 0;
+    plane->cold->preempt_overhead_ns = 0;
+    plane->cold->preemptions = 0;
+    plane->cold->separation = 0;
+    plane->cold->overtaken = 0;
+    plane->cold->queued_seq = 0;
+    sem_init(&plane->cold->resume_sem, 0, 0); // Initialize to 0, will be posted when can resume
+    plane->heap_index = -1;
+    plane->runway_id = -1;
+    plane->duration = 0;
+}
+
+// Queue a class belongs to (emergency classes preempt normal traffic)
+PriorityLevel priority_class_level(PriorityClass priority_class)
+{
+    return (priority_class < CLASS_SCHEDULED) ? EMERGENCY : NORMAL;
 }
 
 // Convert enum to string for display
@@ -31,6 +62,21 @@ const char *priority_to_string(PriorityLevel priority)
     return (priority == EMERGENCY) ? "EMERGENCY" : "NORMAL";
 }
 
+const char *priority_class_to_string(PriorityClass priority_class)
+{
+    switch (priority_class)
+    {
+    case CLASS_FUEL_CRITICAL:
+        return "FUEL_CRITICAL";
+    case CLASS_MEDICAL:
+        return "MEDICAL";
+    case CLASS_SCHEDULED:
+        return "SCHEDULED";
+    default:
+        return "UNKNOWN";
+    }
+}
+
 const char *state_to_string(PlaneState state)
 {
     switch (state)
@@ -50,50 +96,14 @@ const char *state_to_string(PlaneState state)
     }
 }
 
-// Main plane thread function
+// Main plane thread function; the plane is already in the waiting set
 void *plane_thread_function(void *arg)
 {
     Plane *plane = (Plane *)arg;
 
-    // Log arrival
-    runway_print_status("[ARRIVAL] Plane %d (%s, %s) requesting runway access",
-                        plane->id,
-                        priority_to_string(plane->priority),
-                        operation_to_string(plane->operation));
+    affinity_apply(&affinity, AFFINITY_PLANE);
 
-    // Add to appropriate queue
-    plane->state = WAITING;
-    if (plane->priority == EMERGENCY)
-    {
-        queue_enqueue(&runway_system.emergency_queue, plane);
-        sem_post(&runway_system.emergency_queue_sem); // Signal emergency queue has item
-
-        // Set emergency flag to alert active plane
-        sem_wait(&runway_system.emergency_flag_sem);
-        runway_system.emergency_flag = 1;
-        sem_post(&runway_system.emergency_flag_sem);
-
-        runway_print_status("[EMERGENCY] Plane %d added to EMERGENCY queue (Queue size: %d)",
-                            plane->id,
-                            queue_get_count(&runway_system.emergency_queue));
-        // Update GUI
-        gui_update_queues();
-        gui_update_stats();
-    }
-    else
-    {
-        queue_enqueue(&runway_system.normal_queue, plane);
-        sem_post(&runway_system.normal_queue_sem); // Signal normal queue has item
-
-        runway_print_status("[QUEUE] Plane %d added to NORMAL queue (Queue size: %d)",
-                            plane->id,
-                            queue_get_count(&runway_system.normal_queue));
-        // Update GUI
-        gui_update_queues();
-        gui_update_stats();
-    }
-
-    // Request runway access (priority-based scheduling)
+    // Wait for the dispatcher to grant runway access (priority-based scheduling)
     runway_request_access(plane);
 
     // Perform runway operation (with checkpoint/resume)
@@ -104,26 +114,61 @@ void *plane_thread_function(void *arg)
 
     // Mark as completed
     plane->state = COMPLETED;
-    plane->completion_time = time(NULL);
+    plane_record_lifecycle(plane);
 
-    runway_print_status("[COMPLETED] Plane %d finished %s (Total time: %ld seconds)",
-                        plane->id,
-                        operation_to_string(plane->operation),
-                        plane->completion_time - plane->arrival_time);
+    BUS_PUBLISH(BUS_COMPLETED, plane, -1, plane->cold->completion_ns - plane->cold->arrival_ns);
 
     // Increment completed counter
-    sem_wait(&runway_system.completed_sem);
-    runway_system.planes_completed++;
-    sem_post(&runway_system.completed_sem);
-
-    // Update GUI
-    gui_update_stats();
+    stats_add(&runway_stats, STAT_PLANES_COMPLETED, 1);
 
+    // Hand cached queue nodes back before the thread exits
+    pool_thread_flush();
+    logger_thread_release(&logger);
     return NULL;
 }
 
 // Destroy plane resources
 void plane_destroy(Plane *plane)
 {
-    sem_destroy(&plane->resume_sem);
+    sem_destroy(&plane->cold->resume_sem);
+    pool_free(&plane_cold_pool, plane->cold);
+    plane->cold = NULL;
+}
+
+// Stamp completion and add the plane's queue wait, service time and
+// preemption overhead to its class totals
+void plane_record_lifecycle(Plane *plane)
+{
+    PlaneCold *cold = plane->cold;
+    cold->completion_ns = sim_now_ns();
+
+    long long phases[PHASE_COUNT];
+    phases[PHASE_QUEUE_WAIT] = cold->first_grant_ns - cold->arrival_ns;
+    phases[PHASE_SERVICE] = cold->service_ns;
+    phases[PHASE_PREEMPT_OVERHEAD] = cold->preempt_overhead_ns;
+    stats_record_lifecycle(&runway_stats, plane->priority_class, phases, cold->preemptions);
+    if (event_log_enabled)
+        eventlog_record(&event_log, cold->completion_ns, EVLOG_COMPLETED, plane->id, -1,
+                        plane->priority_class, plane->checkpoint_progress);
+}
+
+// Count one slab of hot records; only the packed scheduling fields are read
+static void plane_census_slab(void *objects, int count, void *arg)
+{
+    PlaneCensus *census = (PlaneCensus *)arg;
+    Plane *planes = (Plane *)objects;
+    for (int i = 0; i < count; i++)
+    {
+        if (planes[i].cold == NULL || planes[i].state > COMPLETED)
+            continue;
+        census->states[planes[i].state]++;
+        census->total++;
+    }
+}
+
+// Live planes per state, from a linear sweep of the plane pool's slabs
+void plane_census(PlaneCensus *census)
+{
+    memset(census, 0, sizeof(*census));
+    pool_sweep(&plane_pool, plane_census_slab, census);
 }
@@ -19,6 +19,15 @@ typedef enum
     EMERGENCY
 } PriorityLevel;
 
+// Scheduling class used by the priority heap (lower value is served first)
+typedef enum
+{
+    CLASS_FUEL_CRITICAL, // Emergency: minimum fuel
+    CLASS_MEDICAL,       // Emergency: medical on board
+    CLASS_SCHEDULED,     // Normal scheduled traffic
+    PRIORITY_CLASS_COUNT
+} PriorityClass;
+
 // Plane state
 typedef enum
 {
@@ -29,27 +38,62 @@ typedef enum
     COMPLETED
 } PlaneState;
 
-// Plane structure
+#define PLANE_NO_TIME -1 // Lifecycle timestamp not reached yet
+
+// Rarely touched per-plane state, kept out of the scheduling record
+typedef struct
+{
+    pthread_t thread;
+    sem_t resume_sem; // Semaphore to signal when plane can resume
+    // Lifecycle timestamps from sim_now_ns() (PLANE_NO_TIME until reached)
+    long long arrival_ns;     // First joined a queue
+    long long first_grant_ns; // First runway grant
+    long long granted_ns;     // Latest grant
+    long long preempted_ns;   // Latest preemption, until the plane is granted again
+    long long completion_ns;  // Operation finished
+    // Accumulated lifecycle durations
+    long long service_ns;          // Time holding a runway
+    long long preempt_overhead_ns; // Time between each preemption and the next grant
+    int preemptions;
+    // Runway sequencing
+    int separation; // Seconds of separation behind the previous operation, added at first grant
+    int overtaken;  // Later arrivals the sequencer has granted ahead of this plane
+    unsigned long queued_seq; // When it last joined a FIFO queue (RunwaySystem.queued_seq)
+} PlaneCold;
+
+// Hot scheduling record: 32 bytes, two planes per cache line in the pool slabs.
+// The enums are stored in single bytes.
 typedef struct Plane
 {
     int id;
-    OperationType operation;
-    PriorityLevel priority;
-    PlaneState state;
+    int heap_index;          // Position in the priority heap (-1 when not in it)
+    PlaneCold *cold;         // Side-table record (NULL while the slot is free)
+    int runway_id;           // Runway in use (-1 when not on a runway)
+    int duration;            // Seconds on the runway from a trace (0 = runway default)
     int checkpoint_progress; // 0-100%
-    time_t arrival_time;
-    time_t start_time;
-    time_t completion_time;
-    pthread_t thread;
-    sem_t resume_sem; // Semaphore to signal when plane can resume
+    unsigned char state;     // PlaneState
+    unsigned char operation; // OperationType
+    unsigned char priority;  // PriorityLevel
+    unsigned char priority_class; // PriorityClass
 } Plane;
 
+// Live planes per state, from one sweep of the plane table
+typedef struct
+{
+    int states[COMPLETED + 1];
+    int total;
+} PlaneCensus;
+
 // Plane functions
 void plane_init(Plane *plane, int id, OperationType op, PriorityLevel priority);
 void *plane_thread_function(void *arg);
 void plane_destroy(Plane *plane);
+void plane_census(PlaneCensus *census);
+void plane_record_lifecycle(Plane *plane);
+PriorityLevel priority_class_level(PriorityClass priority_class);
 const char *operation_to_string(OperationType op);
 const char *priority_to_string(PriorityLevel priority);
+const char *priority_class_to_string(PriorityClass priority_class);
 const char *state_to_string(PlaneState state);
 
 #endif // PLANE_H
@@ -0,0 +1,181 @@
+#include "policy.h"
+#include <string.h>
+
+// Heap key span per priority class for shortest-remaining-time
+#define POLICY_CLASS_SPAN_MS (1LL << 40)
+
+// Runway time a plane still needs from its checkpoint
+static long long policy_remaining_ms(Plane *plane)
+{
+    return (long long)runway_operation_duration(plane) * 1000 * (100 - plane->checkpoint_progress) / 100;
+}
+
+// Time by which a plane should have finished, from its first arrival
+static long long policy_deadline_ms(Plane *plane)
+{
+    static const int deadline_s[PRIORITY_CLASS_COUNT] = {
+        POLICY_DEADLINE_FUEL_CRITICAL_S, POLICY_DEADLINE_MEDICAL_S, POLICY_DEADLINE_SCHEDULED_S};
+    return plane->cold->arrival_ns / 1000000 + deadline_s[plane->priority_class] * 1000LL;
+}
+
+static int policy_accepts(void *arg, Plane *plane)
+{
+    return runway_accepts((Runway *)arg, plane);
+}
+
+// First plane in queue order this runway accepts. A landing-only or
+// takeoff-only runway looks past planes it cannot serve instead of idling.
+static Plane *policy_queue_take(Queue *queue, Runway *runway)
+{
+    Plane *head = queue_peek(queue);
+    if (head == NULL)
+        return NULL;
+    if (!runway_accepts(runway, head) && !queue_promote(queue, policy_accepts, runway))
+        return NULL;
+    return queue_dequeue(queue);
+}
+
+// Highest-ranked plane this runway accepts (the heap-based policies)
+static Plane *policy_heap_select_next(RunwaySystem *sys, Runway *runway)
+{
+    return pqueue_extract_first(&sys->waiting_heap, policy_accepts, runway);
+}
+
+// First come, first served: emergency queue first, then normal, each FIFO
+// among the planes the runway accepts (the sequencer may reorder the front
+// of the normal queue). Emergencies always preempt and preempted planes
+// rejoin the back of their queue.
+Plane *policy_fcfs_select_next(RunwaySystem *sys, Runway *runway)
+{
+    Plane *next = policy_queue_take(&sys->emergency_queue, runway);
+    if (next != NULL)
+        return next;
+
+    if (sys->sequence_window <= 1)
+        return policy_queue_take(&sys->normal_queue, runway);
+
+    runway_resequence(sys, runway);
+    next = policy_queue_take(&sys->normal_queue, runway);
+    if (next != NULL)
+        runway_note_overtaking(sys, next);
+    return next;
+}
+
+int policy_fcfs_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency)
+{
+    (void)sys;
+    (void)runway;
+    (void)emergency;
+    return 1;
+}
+
+// Priority with aging: heap ordered by class, waiting aging_ms moves a plane
+// up one class. An aged normal plane at the top holds off emergencies, so an
+// emergency only preempts once it is next in line.
+Plane *policy_aging_select_next(RunwaySystem *sys, Runway *runway)
+{
+    return policy_heap_select_next(sys, runway);
+}
+
+int policy_aging_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency)
+{
+    (void)sys;
+    (void)runway;
+    (void)emergency;
+    return 1;
+}
+
+// Shortest remaining time within each class, from checkpoint_progress
+static long long policy_srt_key(Plane *plane, long long enqueue_ms)
+{
+    (void)enqueue_ms;
+    return plane->priority_class * POLICY_CLASS_SPAN_MS + policy_remaining_ms(plane);
+}
+
+Plane *policy_srt_select_next(RunwaySystem *sys, Runway *runway)
+{
+    return policy_heap_select_next(sys, runway);
+}
+
+// Leave a normal plane that will be done before the emergency would be
+int policy_srt_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency)
+{
+    (void)sys;
+    return policy_remaining_ms(emergency) < policy_remaining_ms(runway->active_plane);
+}
+
+// Earliest deadline first, with per-class deadlines after first arrival;
+// a long-waiting normal plane can rank ahead of a new emergency
+static long long policy_edf_key(Plane *plane, long long enqueue_ms)
+{
+    (void)enqueue_ms;
+    return policy_deadline_ms(plane);
+}
+
+Plane *policy_edf_select_next(RunwaySystem *sys, Runway *runway)
+{
+    return policy_heap_select_next(sys, runway);
+}
+
+int policy_edf_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency)
+{
+    (void)sys;
+    return policy_deadline_ms(emergency) < policy_deadline_ms(runway->active_plane);
+}
+
+// Shared on_requeue: a preempted plane goes back into the waiting set the way
+// a new arrival does. FIFO queues take it at the back; the heap policies key
+// it on insert, so it ages again from the requeue (aging), ranks by what is
+// left after its progress (srt) or keeps its first arrival's deadline (edf).
+void policy_default_on_requeue(RunwaySystem *sys, Plane *plane)
+{
+    runway_insert_waiting(sys, plane);
+}
+
+const SchedPolicy policy_fcfs = {
+    "fcfs", "emergency queue first, FIFO within each queue",
+    0, NULL,
+    policy_fcfs_select_next, policy_fcfs_should_preempt, policy_default_on_requeue};
+
+const SchedPolicy policy_aging = {
+    "aging", "priority heap, waiting ages a plane one class",
+    1, NULL,
+    policy_aging_select_next, policy_aging_should_preempt, policy_default_on_requeue};
+
+const SchedPolicy policy_srt = {
+    "srt", "shortest remaining time within each class",
+    1, policy_srt_key,
+    policy_srt_select_next, policy_srt_should_preempt, policy_default_on_requeue};
+
+const SchedPolicy policy_edf = {
+    "edf", "earliest deadline first",
+    1, policy_edf_key,
+    policy_edf_select_next, policy_edf_should_preempt, policy_default_on_requeue};
+
+static const SchedPolicy *const policy_table[] = {&policy_fcfs, &policy_aging, &policy_srt, &policy_edf};
+
+// Look up a policy by name; a POLICY=<name> build only offers that one
+const SchedPolicy *policy_find(const char *name)
+{
+    for (size_t i = 0; i < sizeof(policy_table) / sizeof(policy_table[0]); i++)
+    {
+        if (strcmp(policy_table[i]->name, name) != 0)
+            continue;
+#ifdef POLICY_FIXED
+        if (policy_table[i] != POLICY_DEFAULT)
+            return NULL;
+#endif
+        return policy_table[i];
+    }
+    return NULL;
+}
+
+// Names accepted by policy_find, for usage and error messages
+const char *policy_names()
+{
+#ifdef POLICY_FIXED
+    return POLICY_DEFAULT->name;
+#else
+    return "fcfs, aging, srt, edf";
+#endif
+}
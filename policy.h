@@ -0,0 +1,76 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "plane.h"
+#include "runway.h"
+#include "pqueue.h"
+
+#define POLICY_DEFAULT_AGING_MS 60000 // -p aging without -a
+
+// Completion deadlines after first arrival used by earliest-deadline-first
+#define POLICY_DEADLINE_FUEL_CRITICAL_S 60
+#define POLICY_DEADLINE_MEDICAL_S 180
+#define POLICY_DEADLINE_SCHEDULED_S 1800
+
+// Scheduling policy: who gets a free runway, whether a waiting emergency
+// preempts a runway's normal plane, and where a preempted plane goes back.
+// Every callback runs under sched_sem in every mode; first arrivals bypass
+// the policy and go straight into the queue or heap.
+typedef struct SchedPolicy
+{
+    const char *name;
+    const char *description;
+    int use_priority_heap;   // Waiting set: priority heap (1) or emergency/normal FIFO queues (0)
+    PQKeyFunction heap_key;  // Heap order (NULL = class with aging, see pqueue.h)
+    Plane *(*select_next)(RunwaySystem *sys, Runway *runway);
+    int (*should_preempt)(RunwaySystem *sys, Runway *runway, Plane *emergency);
+    void (*on_requeue)(RunwaySystem *sys, Plane *plane);
+} SchedPolicy;
+
+// Built-in policies
+extern const SchedPolicy policy_fcfs;
+extern const SchedPolicy policy_aging;
+extern const SchedPolicy policy_srt;
+extern const SchedPolicy policy_edf;
+
+Plane *policy_fcfs_select_next(RunwaySystem *sys, Runway *runway);
+int policy_fcfs_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency);
+Plane *policy_aging_select_next(RunwaySystem *sys, Runway *runway);
+int policy_aging_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency);
+Plane *policy_srt_select_next(RunwaySystem *sys, Runway *runway);
+int policy_srt_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency);
+Plane *policy_edf_select_next(RunwaySystem *sys, Runway *runway);
+int policy_edf_should_preempt(RunwaySystem *sys, Runway *runway, Plane *emergency);
+void policy_default_on_requeue(RunwaySystem *sys, Plane *plane);
+
+// Policy calls on the scheduling path. A build with make POLICY=<name> binds
+// them to that policy at compile time; otherwise the default FCFS policy is
+// called directly and only the other policies go through the table.
+#ifdef POLICY_FIXED
+#define POLICY_PASTE(name, fn) policy_##name##_##fn
+#define POLICY_BIND(name, fn) POLICY_PASTE(name, fn)
+#define POLICY_TABLE_PASTE(name) policy_##name
+#define POLICY_TABLE(name) POLICY_TABLE_PASTE(name)
+#define POLICY_DEFAULT (&POLICY_TABLE(POLICY_FIXED))
+#define POLICY_SELECT_NEXT(sys, runway) POLICY_BIND(POLICY_FIXED, select_next)(sys, runway)
+#define POLICY_SHOULD_PREEMPT(sys, runway, emergency) POLICY_BIND(POLICY_FIXED, should_preempt)(sys, runway, emergency)
+#else
+#define POLICY_DEFAULT (&policy_fcfs)
+#define POLICY_SELECT_NEXT(sys, runway) \
+    ((sys)->policy == &policy_fcfs ? policy_fcfs_select_next(sys, runway) : (sys)->policy->select_next(sys, runway))
+#define POLICY_SHOULD_PREEMPT(sys, runway, emergency) \
+    ((sys)->policy == &policy_fcfs ? policy_fcfs_should_preempt(sys, runway, emergency) \
+                                   : (sys)->policy->should_preempt(sys, runway, emergency))
+#endif
+
+// Every built-in policy requeues through the shared default, called directly;
+// only a policy with its own on_requeue goes through the table
+#define POLICY_ON_REQUEUE(sys, plane) \
+    ((sys)->policy->on_requeue == policy_default_on_requeue ? policy_default_on_requeue(sys, plane) \
+                                                             : (sys)->policy->on_requeue(sys, plane))
+
+// Policy functions
+const SchedPolicy *policy_find(const char *name);
+const char *policy_names();
+
+#endif // POLICY_H
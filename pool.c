@@ -0,0 +1,198 @@
+#include "pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdalign.h>
+#include <string.h>
+
+// Object pools used by the scheduler
+Pool plane_pool;
+Pool plane_cold_pool;
+Pool queue_node_pool;
+
+// Per-thread cache of free objects for one pool
+typedef struct
+{
+    void *objects[POOL_CACHE_SIZE];
+    int count;
+} PoolCache;
+
+static Pool *pool_registry[POOL_MAX_POOLS];
+static atomic_int pool_registry_count = 0;
+static _Thread_local PoolCache pool_caches[POOL_MAX_POOLS];
+
+// Slab header, padded so the objects start on the next cache line
+typedef union SlabHeader
+{
+    void *next;
+    char pad[POOL_SLAB_ALIGN];
+} SlabHeader;
+
+// Initialize pool (objects are rounded up to maximum alignment)
+void pool_init(Pool *pool, const char *name, size_t object_size)
+{
+    size_t align = alignof(max_align_t);
+    if (object_size < sizeof(void *))
+        object_size = sizeof(void *);
+
+    pool->name = name;
+    pool->object_size = (object_size + align - 1) / align * align;
+    pool->free_list = NULL;
+    pool->slabs = NULL;
+    sem_init(&pool->lock, 0, 1); // Binary semaphore initialized to 1
+
+    atomic_init(&pool->allocs, 0);
+    atomic_init(&pool->frees, 0);
+    atomic_init(&pool->slab_count, 0);
+    atomic_init(&pool->refills, 0);
+    atomic_init(&pool->peak_in_use, 0);
+
+    pool->id = atomic_fetch_add(&pool_registry_count, 1);
+    if (pool->id >= POOL_MAX_POOLS)
+    {
+        fprintf(stderr, "Error: Too many pools (max %d)\n", POOL_MAX_POOLS);
+        exit(1);
+    }
+    pool_registry[pool->id] = pool;
+}
+
+// Carve a new, zeroed slab into the shared free list (caller holds pool->lock)
+static int pool_grow(Pool *pool)
+{
+    size_t size = sizeof(SlabHeader) + POOL_SLAB_OBJECTS * pool->object_size;
+    size = (size + POOL_SLAB_ALIGN - 1) / POOL_SLAB_ALIGN * POOL_SLAB_ALIGN;
+    SlabHeader *slab = (SlabHeader *)aligned_alloc(POOL_SLAB_ALIGN, size);
+    if (slab == NULL)
+    {
+        perror("Failed to allocate pool slab");
+        return -1;
+    }
+    memset(slab, 0, size);
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    char *objects = (char *)(slab + 1);
+    for (int i = POOL_SLAB_OBJECTS - 1; i >= 0; i--)
+    {
+        void *object = objects + i * pool->object_size;
+        *(void **)object = pool->free_list;
+        pool->free_list = object;
+    }
+
+    atomic_fetch_add_explicit(&pool->slab_count, 1, memory_order_relaxed);
+    return 0;
+}
+
+// Move half a cache worth of objects from the shared free list
+static void pool_refill(Pool *pool, PoolCache *cache)
+{
+    sem_wait(&pool->lock);
+    while (cache->count < POOL_CACHE_SIZE / 2)
+    {
+        if (pool->free_list == NULL && pool_grow(pool) != 0)
+            break;
+        void *object = pool->free_list;
+        pool->free_list = *(void **)object;
+        cache->objects[cache->count++] = object;
+    }
+    sem_post(&pool->lock);
+
+    atomic_fetch_add_explicit(&pool->refills, 1, memory_order_relaxed);
+}
+
+// Return cached objects to the shared free list, keeping the first keep
+static void pool_flush(Pool *pool, PoolCache *cache, int keep)
+{
+    sem_wait(&pool->lock);
+    while (cache->count > keep)
+    {
+        void *object = cache->objects[--cache->count];
+        *(void **)object = pool->free_list;
+        pool->free_list = object;
+    }
+    sem_post(&pool->lock);
+}
+
+// Allocate an object (thread cache first, then shared free list, then a new slab)
+void *pool_alloc(Pool *pool)
+{
+    PoolCache *cache = &pool_caches[pool->id];
+    if (cache->count == 0)
+    {
+        pool_refill(pool, cache);
+        if (cache->count == 0)
+            return NULL;
+    }
+
+    long in_use = atomic_fetch_add_explicit(&pool->allocs, 1, memory_order_relaxed) + 1 -
+                  atomic_load_explicit(&pool->frees, memory_order_relaxed);
+    long peak = atomic_load_explicit(&pool->peak_in_use, memory_order_relaxed);
+    while (in_use > peak &&
+           !atomic_compare_exchange_weak_explicit(&pool->peak_in_use, &peak, in_use,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        ;
+
+    return cache->objects[--cache->count];
+}
+
+// Free an object into the calling thread's cache
+void pool_free(Pool *pool, void *object)
+{
+    if (object == NULL)
+        return;
+
+    PoolCache *cache = &pool_caches[pool->id];
+    if (cache->count == POOL_CACHE_SIZE)
+    {
+        pool_flush(pool, cache, POOL_CACHE_SIZE / 2);
+    }
+    cache->objects[cache->count++] = object;
+
+    atomic_fetch_add_explicit(&pool->frees, 1, memory_order_relaxed);
+}
+
+// Return all of the calling thread's cached objects (call before thread exit)
+void pool_thread_flush()
+{
+    int count = atomic_load(&pool_registry_count);
+    for (int i = 0; i < count && i < POOL_MAX_POOLS; i++)
+    {
+        if (pool_caches[i].count > 0)
+            pool_flush(pool_registry[i], &pool_caches[i], 0);
+    }
+}
+
+// Objects currently handed out
+long pool_in_use(Pool *pool)
+{
+    return atomic_load(&pool->allocs) - atomic_load(&pool->frees);
+}
+
+// Visit every slab as one contiguous array of objects, live or free.
+// Free objects have their first word overwritten by the free-list link.
+void pool_sweep(Pool *pool, void (*visit)(void *objects, int count, void *arg), void *arg)
+{
+    sem_wait(&pool->lock);
+    for (SlabHeader *slab = (SlabHeader *)pool->slabs; slab != NULL; slab = (SlabHeader *)slab->next)
+        visit(slab + 1, POOL_SLAB_OBJECTS, arg);
+    sem_post(&pool->lock);
+}
+
+// Destroy pool and release all slabs
+void pool_destroy(Pool *pool)
+{
+    // Drop this thread's cached pointers into the slabs being freed
+    pool_caches[pool->id].count = 0;
+
+    sem_wait(&pool->lock);
+    SlabHeader *slab = (SlabHeader *)pool->slabs;
+    while (slab != NULL)
+    {
+        SlabHeader *next = (SlabHeader *)slab->next;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    sem_post(&pool->lock);
+    sem_destroy(&pool->lock);
+}
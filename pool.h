@@ -0,0 +1,45 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+
+#define POOL_MAX_POOLS 8     // Pools that can have per-thread caches
+#define POOL_CACHE_SIZE 32   // Objects held per thread before flushing to the pool
+#define POOL_SLAB_OBJECTS 256 // Objects carved from each heap slab
+#define POOL_SLAB_ALIGN 64    // Slabs start on a cache line
+
+// Fixed-size object pool: slabs carved into a shared free list, fronted by
+// per-thread caches so steady-state alloc/free never touches the heap
+typedef struct Pool
+{
+    const char *name;
+    size_t object_size;
+    int id;             // Index into the per-thread cache table
+    void *free_list;    // Shared free objects (first word links to next)
+    void *slabs;        // All slabs, freed on destroy
+    sem_t lock;         // Binary semaphore protecting free_list and slabs
+
+    atomic_long allocs;
+    atomic_long frees;
+    atomic_long slab_count;
+    atomic_long refills; // Cache refills from the shared free list
+    atomic_long peak_in_use;
+} Pool;
+
+// Object pools used by the scheduler
+extern Pool plane_pool;
+extern Pool plane_cold_pool;
+extern Pool queue_node_pool;
+
+// Pool functions
+void pool_init(Pool *pool, const char *name, size_t object_size);
+void *pool_alloc(Pool *pool);
+void pool_free(Pool *pool, void *object);
+void pool_thread_flush();
+long pool_in_use(Pool *pool);
+void pool_sweep(Pool *pool, void (*visit)(void *objects, int count, void *arg), void *arg);
+void pool_destroy(Pool *pool);
+
+#endif // POOL_H
@@ -0,0 +1,280 @@
+#include "pqueue.h"
+#include "plane.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Ordering key for a plane's class and enqueue time
+static long long pq_key(PQueue *pq, Plane *plane, long long enqueue_ms)
+{
+    if (pq->key_fn != NULL)
+        return pq->key_fn(plane, enqueue_ms);
+    if (pq->aging_ms > 0)
+        return plane->priority_class * pq->aging_ms + enqueue_ms;
+    return plane->priority_class;
+}
+
+static int pq_before(const PQEntry *a, const PQEntry *b)
+{
+    if (a->key != b->key)
+        return a->key < b->key;
+    return a->seq < b->seq;
+}
+
+// Place an entry at index i and record the index in its plane
+static void pq_set(PQueue *pq, int i, PQEntry entry)
+{
+    pq->entries[i] = entry;
+    entry.plane->heap_index = i;
+}
+
+static void pq_sift_up(PQueue *pq, int i)
+{
+    PQEntry entry = pq->entries[i];
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!pq_before(&entry, &pq->entries[parent]))
+            break;
+        pq_set(pq, i, pq->entries[parent]);
+        i = parent;
+    }
+    pq_set(pq, i, entry);
+}
+
+static void pq_sift_down(PQueue *pq, int i)
+{
+    PQEntry entry = pq->entries[i];
+    while (1)
+    {
+        int child = 2 * i + 1;
+        if (child >= pq->count)
+            break;
+        if (child + 1 < pq->count && pq_before(&pq->entries[child + 1], &pq->entries[child]))
+            child++;
+        if (!pq_before(&pq->entries[child], &entry))
+            break;
+        pq_set(pq, i, pq->entries[child]);
+        i = child;
+    }
+    pq_set(pq, i, entry);
+}
+
+// Remove the entry at index i (caller holds sem_access)
+static struct Plane *pq_remove_at(PQueue *pq, int i)
+{
+    Plane *plane = pq->entries[i].plane;
+    pq->level_counts[plane->priority_class]--;
+    plane->heap_index = -1;
+
+    pq->count--;
+    if (i < pq->count)
+    {
+        pq_set(pq, i, pq->entries[pq->count]);
+        pq_sift_down(pq, i);
+        pq_sift_up(pq, pq->entries[i].plane->heap_index);
+    }
+    return plane;
+}
+
+// Initialize priority heap
+void pqueue_init(PQueue *pq, int levels, long long aging_ms)
+{
+    if (levels < 1)
+        levels = 1;
+    if (levels > PQ_MAX_LEVELS)
+        levels = PQ_MAX_LEVELS;
+
+    pq->entries = NULL;
+    pq->count = 0;
+    pq->capacity = 0;
+    pq->levels = levels;
+    pq->aging_ms = aging_ms;
+    pq->key_fn = NULL;
+    pq->next_seq = 0;
+    for (int i = 0; i < PQ_MAX_LEVELS; i++)
+        pq->level_counts[i] = 0;
+    sem_init(&pq->sem_access, 0, 1); // Binary semaphore initialized to 1
+}
+
+// Add one entry (caller holds sem_access)
+static int pq_insert_locked(PQueue *pq, Plane *plane, long long now_ms)
+{
+    if (pq->count == pq->capacity)
+    {
+        int new_capacity = (pq->capacity == 0) ? 64 : pq->capacity * 2;
+        PQEntry *entries = (PQEntry *)realloc(pq->entries, new_capacity * sizeof(PQEntry));
+        if (entries == NULL)
+        {
+            perror("Failed to grow priority heap");
+            return -1;
+        }
+        pq->entries = entries;
+        pq->capacity = new_capacity;
+    }
+
+    if ((int)plane->priority_class >= pq->levels)
+        plane->priority_class = pq->levels - 1;
+
+    PQEntry entry = {pq_key(pq, plane, now_ms), pq->next_seq++, now_ms, plane};
+    pq->level_counts[plane->priority_class]++;
+    pq->entries[pq->count] = entry;
+    pq_sift_up(pq, pq->count++);
+    return 0;
+}
+
+// Insert a plane keyed on its priority class and the current time
+int pqueue_insert(PQueue *pq, Plane *plane, long long now_ms)
+{
+    sem_wait(&pq->sem_access);
+    int result = pq_insert_locked(pq, plane, now_ms);
+    sem_post(&pq->sem_access);
+    return result;
+}
+
+// Insert count planes arriving together with one lock acquisition;
+// returns the number inserted
+int pqueue_insert_batch(PQueue *pq, Plane **planes, int count, long long now_ms)
+{
+    sem_wait(&pq->sem_access);
+    int n = 0;
+    while (n < count && pq_insert_locked(pq, planes[n], now_ms) == 0)
+        n++;
+    sem_post(&pq->sem_access);
+    return n;
+}
+
+// Remove and return the highest-priority plane
+Plane *pqueue_extract_min(PQueue *pq)
+{
+    sem_wait(&pq->sem_access);
+    Plane *plane = (pq->count > 0) ? pq_remove_at(pq, 0) : NULL;
+    sem_post(&pq->sem_access);
+    return plane;
+}
+
+// Index of the first entry in heap order at or below i that match() accepts,
+// or best if that comes first. Subtrees rooted after best are skipped, since
+// every entry below a node orders after it.
+static int pq_find_first(PQueue *pq, int i, int best, PQMatchFunction match, void *arg)
+{
+    if (i >= pq->count)
+        return best;
+    if (best >= 0 && !pq_before(&pq->entries[i], &pq->entries[best]))
+        return best;
+    if (match(arg, pq->entries[i].plane))
+        return i;
+    best = pq_find_first(pq, 2 * i + 1, best, match, arg);
+    return pq_find_first(pq, 2 * i + 2, best, match, arg);
+}
+
+// Remove and return the highest-priority plane that match() accepts
+Plane *pqueue_extract_first(PQueue *pq, PQMatchFunction match, void *arg)
+{
+    sem_wait(&pq->sem_access);
+    int i = pq_find_first(pq, 0, -1, match, arg);
+    Plane *plane = (i >= 0) ? pq_remove_at(pq, i) : NULL;
+    sem_post(&pq->sem_access);
+    return plane;
+}
+
+// Peek at the highest-priority plane without removing
+Plane *pqueue_peek(PQueue *pq)
+{
+    sem_wait(&pq->sem_access);
+    Plane *plane = (pq->count > 0) ? pq->entries[0].plane : NULL;
+    sem_post(&pq->sem_access);
+    return plane;
+}
+
+// Raise a waiting plane to a more urgent class (e.g. fuel becomes critical)
+int pqueue_decrease_key(PQueue *pq, Plane *plane, int new_class)
+{
+    sem_wait(&pq->sem_access);
+
+    int i = plane->heap_index;
+    if (i < 0 || i >= pq->count || pq->entries[i].plane != plane ||
+        new_class < 0 || new_class > (int)plane->priority_class)
+    {
+        sem_post(&pq->sem_access);
+        return -1;
+    }
+
+    pq->level_counts[plane->priority_class]--;
+    pq->level_counts[new_class]++;
+    plane->priority_class = new_class;
+    pq->entries[i].key = pq_key(pq, plane, pq->entries[i].enqueue_ms);
+    pq_sift_up(pq, i);
+
+    sem_post(&pq->sem_access);
+    return 0;
+}
+
+// Remove an arbitrary waiting plane
+int pqueue_remove(PQueue *pq, Plane *plane)
+{
+    sem_wait(&pq->sem_access);
+
+    int i = plane->heap_index;
+    if (i < 0 || i >= pq->count || pq->entries[i].plane != plane)
+    {
+        sem_post(&pq->sem_access);
+        return -1;
+    }
+    pq_remove_at(pq, i);
+
+    sem_post(&pq->sem_access);
+    return 0;
+}
+
+// Get number of waiting planes
+int pqueue_get_count(PQueue *pq)
+{
+    sem_wait(&pq->sem_access);
+    int count = pq->count;
+    sem_post(&pq->sem_access);
+    return count;
+}
+
+// Get number of waiting planes in one class
+int pqueue_level_count(PQueue *pq, int level)
+{
+    if (level < 0 || level >= PQ_MAX_LEVELS)
+        return 0;
+    sem_wait(&pq->sem_access);
+    int count = pq->level_counts[level];
+    sem_post(&pq->sem_access);
+    return count;
+}
+
+// Call visit on up to max waiting planes whose class is in [min_level,
+// max_level], in heap order, while the heap is locked
+int pqueue_visit(PQueue *pq, int min_level, int max_level, int max, PQVisitFunction visit, void *arg)
+{
+    sem_wait(&pq->sem_access);
+
+    int n = 0;
+    for (int i = 0; i < pq->count && n < max; i++)
+    {
+        int level = pq->entries[i].plane->priority_class;
+        if (level >= min_level && level <= max_level)
+        {
+            visit(arg, pq->entries[i].plane);
+            n++;
+        }
+    }
+
+    sem_post(&pq->sem_access);
+    return n;
+}
+
+// Destroy priority heap (planes are owned by the caller)
+void pqueue_destroy(PQueue *pq)
+{
+    sem_wait(&pq->sem_access);
+    free(pq->entries);
+    pq->entries = NULL;
+    pq->count = 0;
+    pq->capacity = 0;
+    sem_post(&pq->sem_access);
+    sem_destroy(&pq->sem_access);
+}
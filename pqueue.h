@@ -0,0 +1,58 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include <semaphore.h>
+
+#define PQ_MAX_LEVELS 16
+
+// Forward declaration
+struct Plane;
+
+// Custom heap order: key for a plane entering the heap at enqueue_ms
+typedef long long (*PQKeyFunction)(struct Plane *plane, long long enqueue_ms);
+
+// Predicate for pqueue_extract_first (e.g. whether a runway accepts the plane)
+typedef int (*PQMatchFunction)(void *arg, struct Plane *plane);
+typedef void (*PQVisitFunction)(void *arg, struct Plane *plane);
+
+// Heap entry: ordered by (key, seq); key folds class and aged wait together
+typedef struct
+{
+    long long key;
+    unsigned long seq;
+    long long enqueue_ms;
+    struct Plane *plane;
+} PQEntry;
+
+// Indexed binary min-heap of waiting planes with multi-level priority and aging.
+// With aging, a plane of class c enqueued at t ranks as c - (now - t) / aging_ms;
+// because now is common to every entry this orders exactly like c * aging_ms + t,
+// so aging never requires re-keying the heap.
+typedef struct
+{
+    PQEntry *entries;
+    int count;
+    int capacity;
+    int levels;                        // Number of priority classes in use
+    long long aging_ms;                // Wait time worth one class level (0 = no aging)
+    PQKeyFunction key_fn;              // Replaces the class/aging key when set
+    unsigned long next_seq;            // Arrival sequence for FIFO tie-breaks
+    int level_counts[PQ_MAX_LEVELS];   // Waiting planes per class
+    sem_t sem_access;                  // Binary semaphore to protect heap operations
+} PQueue;
+
+// Priority heap operations (O(log n) insert, extract-min and decrease-key)
+void pqueue_init(PQueue *pq, int levels, long long aging_ms);
+int pqueue_insert(PQueue *pq, struct Plane *plane, long long now_ms);
+int pqueue_insert_batch(PQueue *pq, struct Plane **planes, int count, long long now_ms);
+struct Plane *pqueue_extract_min(PQueue *pq);
+struct Plane *pqueue_extract_first(PQueue *pq, PQMatchFunction match, void *arg);
+struct Plane *pqueue_peek(PQueue *pq);
+int pqueue_decrease_key(PQueue *pq, struct Plane *plane, int new_class);
+int pqueue_remove(PQueue *pq, struct Plane *plane);
+int pqueue_get_count(PQueue *pq);
+int pqueue_level_count(PQueue *pq, int level);
+int pqueue_visit(PQueue *pq, int min_level, int max_level, int max, PQVisitFunction visit, void *arg);
+void pqueue_destroy(PQueue *pq);
+
+#endif // PQUEUE_H
@@ -1,5 +1,6 @@
 #include "queue.h"
 #include "plane.h"
+#include "pool.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -17,7 +18,7 @@ void queue_enqueue(Queue *queue, Plane *plane)
 {
     sem_wait(&queue->sem_access);
 
-    QueueNode *new_node = (QueueNode *)malloc(sizeof(QueueNode));
+    QueueNode *new_node = (QueueNode *)pool_alloc(&queue_node_pool);
     if (new_node == NULL)
     {
         perror("Failed to allocate queue node");
@@ -46,6 +47,42 @@ void queue_enqueue(Queue *queue, Plane *plane)
     sem_post(&queue->sem_access);
 }
 
+// Enqueue count planes in order with one lock acquisition; the chain is
+// built before the lock is taken. Returns the number enqueued.
+int queue_enqueue_batch(Queue *queue, Plane **planes, int count)
+{
+    QueueNode *first = NULL, *last = NULL;
+    int n = 0;
+    for (; n < count; n++)
+    {
+        QueueNode *node = (QueueNode *)pool_alloc(&queue_node_pool);
+        if (node == NULL)
+        {
+            perror("Failed to allocate queue node");
+            break;
+        }
+        node->plane = planes[n];
+        node->next = NULL;
+        if (last == NULL)
+            first = node;
+        else
+            last->next = node;
+        last = node;
+    }
+    if (n == 0)
+        return 0;
+
+    sem_wait(&queue->sem_access);
+    if (queue->tail == NULL)
+        queue->head = first;
+    else
+        queue->tail->next = first;
+    queue->tail = last;
+    queue->count += n;
+    sem_post(&queue->sem_access);
+    return n;
+}
+
 // Dequeue a plane (remove from head)
 Plane *queue_dequeue(Queue *queue)
 {
@@ -67,7 +104,7 @@ Plane *queue_dequeue(Queue *queue)
     }
 
     queue->count--;
-    free(node);
+    pool_free(&queue_node_pool, node);
 
     sem_post(&queue->sem_access);
     return plane;
@@ -106,6 +143,79 @@ int queue_get_count(Queue *queue)
     return count;
 }
 
+// Copy up to max planes from the front of the queue
+int queue_snapshot(Queue *queue, Plane **planes, int max)
+{
+    sem_wait(&queue->sem_access);
+
+    int n = 0;
+    for (QueueNode *node = queue->head; node != NULL && n < max; node = node->next)
+    {
+        planes[n++] = node->plane;
+    }
+
+    sem_post(&queue->sem_access);
+    return n;
+}
+
+// Call visit on up to max planes from the front of the queue while it is
+// locked, so the planes cannot be dequeued (and freed) underneath it
+int queue_visit(Queue *queue, int max, QueueVisitFunction visit, void *arg)
+{
+    sem_wait(&queue->sem_access);
+
+    int n = 0;
+    for (QueueNode *node = queue->head; node != NULL && n < max; node = node->next)
+    {
+        visit(arg, node->plane);
+        n++;
+    }
+
+    sem_post(&queue->sem_access);
+    return n;
+}
+
+// Overwrite the first count entries with planes (the same planes in a new
+// order, as returned by queue_snapshot); only the consumer may reorder
+int queue_reorder(Queue *queue, Plane **planes, int count)
+{
+    sem_wait(&queue->sem_access);
+
+    int n = 0;
+    for (QueueNode *node = queue->head; node != NULL && n < count; node = node->next)
+    {
+        node->plane = planes[n++];
+    }
+
+    sem_post(&queue->sem_access);
+    return n;
+}
+
+// Move the first plane match() accepts to the head, keeping the planes it
+// passes in order; returns 0 if none matches. Only the consumer may promote.
+int queue_promote(Queue *queue, QueueMatchFunction match, void *arg)
+{
+    sem_wait(&queue->sem_access);
+
+    QueueNode *found = queue->head;
+    while (found != NULL && !match(arg, found->plane))
+        found = found->next;
+    if (found != NULL)
+    {
+        Plane *carry = found->plane;
+        for (QueueNode *node = queue->head; node != found; node = node->next)
+        {
+            Plane *next = node->plane;
+            node->plane = carry;
+            carry = next;
+        }
+        found->plane = carry;
+    }
+
+    sem_post(&queue->sem_access);
+    return found != NULL;
+}
+
 // Destroy queue and free all nodes
 void queue_destroy(Queue *queue)
 {
@@ -115,7 +225,7 @@ void queue_destroy(Queue *queue)
     while (current != NULL)
     {
         QueueNode *next = current->next;
-        free(current);
+        pool_free(&queue_node_pool, current);
         current = next;
     }
 
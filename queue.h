@@ -6,6 +6,29 @@
 // Forward declaration
 struct Plane;
 
+// Predicate for queue_promote (e.g. whether a runway accepts the plane)
+typedef int (*QueueMatchFunction)(void *arg, struct Plane *plane);
+typedef void (*QueueVisitFunction)(void *arg, struct Plane *plane);
+
+#ifdef QUEUE_LOCKFREE
+#include <stdatomic.h>
+
+// Queue node structure
+typedef struct QueueNode
+{
+    struct Plane *plane;
+    _Atomic(struct QueueNode *) next;
+} QueueNode;
+
+// Lock-free multi-producer/single-consumer queue (build with QUEUE=lockfree)
+typedef struct Queue
+{
+    QueueNode *head;              // Consumer side: dummy node before the first plane
+    _Atomic(QueueNode *) tail;    // Producer side: swapped atomically on enqueue
+    atomic_int count;             // Number of linked planes
+    sem_t consumer_sem;           // Binary semaphore serializing consumers (never taken by enqueue)
+} Queue;
+#else
 // Queue node structure
 typedef struct QueueNode
 {
@@ -21,14 +44,20 @@ typedef struct Queue
     int count;
     sem_t sem_access; // Binary semaphore to protect queue operations
 } Queue;
+#endif
 
 // Queue operations
 void queue_init(Queue *queue);
 void queue_enqueue(Queue *queue, struct Plane *plane);
+int queue_enqueue_batch(Queue *queue, struct Plane **planes, int count);
 struct Plane *queue_dequeue(Queue *queue);
 struct Plane *queue_peek(Queue *queue);
 int queue_is_empty(Queue *queue);
 int queue_get_count(Queue *queue);
+int queue_snapshot(Queue *queue, struct Plane **planes, int max);
+int queue_visit(Queue *queue, int max, QueueVisitFunction visit, void *arg);
+int queue_reorder(Queue *queue, struct Plane **planes, int count);
+int queue_promote(Queue *queue, QueueMatchFunction match, void *arg);
 void queue_destroy(Queue *queue);
 
 #endif // QUEUE_H
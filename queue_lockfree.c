@@ -0,0 +1,240 @@
+#include "queue.h"
+#include "plane.h"
+#include "pool.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <sched.h>
+
+// Lock-free MPSC queue: producers append with one atomic exchange and never
+// wait on the consumer; dequeue/peek/snapshot are serialized by consumer_sem.
+
+// Allocate a node
+static QueueNode *queue_node_new(Plane *plane)
+{
+    QueueNode *node = (QueueNode *)pool_alloc(&queue_node_pool);
+    if (node == NULL)
+    {
+        perror("Failed to allocate queue node");
+        return NULL;
+    }
+    node->plane = plane;
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    return node;
+}
+
+// Initialize queue with a dummy node
+void queue_init(Queue *queue)
+{
+    QueueNode *dummy = queue_node_new(NULL);
+    queue->head = dummy;
+    atomic_init(&queue->tail, dummy);
+    atomic_init(&queue->count, 0);
+    sem_init(&queue->consumer_sem, 0, 1); // Binary semaphore initialized to 1
+}
+
+// Enqueue a plane (add to tail); wait-free for producers
+void queue_enqueue(Queue *queue, Plane *plane)
+{
+    QueueNode *new_node = queue_node_new(plane);
+    if (new_node == NULL)
+    {
+        return;
+    }
+
+    QueueNode *prev = atomic_exchange_explicit(&queue->tail, new_node, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, new_node, memory_order_release);
+    atomic_fetch_add_explicit(&queue->count, 1, memory_order_release);
+}
+
+// Enqueue count planes in order: the chain is linked privately, then
+// published with a single tail exchange. Returns the number enqueued.
+int queue_enqueue_batch(Queue *queue, Plane **planes, int count)
+{
+    QueueNode *first = NULL, *last = NULL;
+    int n = 0;
+    for (; n < count; n++)
+    {
+        QueueNode *node = queue_node_new(planes[n]);
+        if (node == NULL)
+            break;
+        if (last == NULL)
+            first = node;
+        else
+            atomic_store_explicit(&last->next, node, memory_order_relaxed);
+        last = node;
+    }
+    if (n == 0)
+        return 0;
+
+    QueueNode *prev = atomic_exchange_explicit(&queue->tail, last, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, first, memory_order_release);
+    atomic_fetch_add_explicit(&queue->count, n, memory_order_release);
+    return n;
+}
+
+// Wait for the next node once a producer has counted it; a producer may
+// sit between its tail exchange and next store for a few instructions
+static QueueNode *queue_next_linked(Queue *queue)
+{
+    QueueNode *next;
+    while ((next = atomic_load_explicit(&queue->head->next, memory_order_acquire)) == NULL)
+    {
+        sched_yield();
+    }
+    return next;
+}
+
+// Dequeue a plane (remove from head)
+Plane *queue_dequeue(Queue *queue)
+{
+    sem_wait(&queue->consumer_sem);
+
+    if (atomic_load_explicit(&queue->count, memory_order_acquire) == 0)
+    {
+        sem_post(&queue->consumer_sem);
+        return NULL;
+    }
+
+    // The first linked node becomes the new dummy
+    QueueNode *node = queue_next_linked(queue);
+    Plane *plane = node->plane;
+    node->plane = NULL;
+
+    QueueNode *old_dummy = queue->head;
+    queue->head = node;
+    atomic_fetch_sub_explicit(&queue->count, 1, memory_order_release);
+    pool_free(&queue_node_pool, old_dummy);
+
+    sem_post(&queue->consumer_sem);
+    return plane;
+}
+
+// Peek at the front plane without removing
+Plane *queue_peek(Queue *queue)
+{
+    sem_wait(&queue->consumer_sem);
+
+    Plane *plane = NULL;
+    if (atomic_load_explicit(&queue->count, memory_order_acquire) > 0)
+    {
+        plane = queue_next_linked(queue)->plane;
+    }
+
+    sem_post(&queue->consumer_sem);
+    return plane;
+}
+
+// Check if queue is empty (no lock)
+int queue_is_empty(Queue *queue)
+{
+    return atomic_load_explicit(&queue->count, memory_order_acquire) == 0;
+}
+
+// Get queue count (no lock)
+int queue_get_count(Queue *queue)
+{
+    return atomic_load_explicit(&queue->count, memory_order_acquire);
+}
+
+// Copy up to max planes from the front of the queue
+int queue_snapshot(Queue *queue, Plane **planes, int max)
+{
+    sem_wait(&queue->consumer_sem);
+
+    int n = 0;
+    QueueNode *node = atomic_load_explicit(&queue->head->next, memory_order_acquire);
+    while (node != NULL && n < max)
+    {
+        planes[n++] = node->plane;
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+
+    sem_post(&queue->consumer_sem);
+    return n;
+}
+
+// Call visit on up to max planes from the front of the queue while holding
+// the consumer side, so the planes cannot be dequeued (and freed) underneath it
+int queue_visit(Queue *queue, int max, QueueVisitFunction visit, void *arg)
+{
+    sem_wait(&queue->consumer_sem);
+
+    int n = 0;
+    QueueNode *node = atomic_load_explicit(&queue->head->next, memory_order_acquire);
+    while (node != NULL && n < max)
+    {
+        visit(arg, node->plane);
+        n++;
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+
+    sem_post(&queue->consumer_sem);
+    return n;
+}
+
+// Overwrite the first count entries with planes (the same planes in a new
+// order, as returned by queue_snapshot). Linked nodes' planes are only
+// touched by the consumer, so producers can keep appending meanwhile.
+int queue_reorder(Queue *queue, Plane **planes, int count)
+{
+    sem_wait(&queue->consumer_sem);
+
+    int n = 0;
+    QueueNode *node = atomic_load_explicit(&queue->head->next, memory_order_acquire);
+    while (node != NULL && n < count)
+    {
+        node->plane = planes[n++];
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+
+    sem_post(&queue->consumer_sem);
+    return n;
+}
+
+// Move the first plane match() accepts to the head, keeping the planes it
+// passes in order; returns 0 if none matches. Like queue_reorder() this only
+// rewrites linked nodes' planes, so producers can keep appending meanwhile.
+int queue_promote(Queue *queue, QueueMatchFunction match, void *arg)
+{
+    sem_wait(&queue->consumer_sem);
+
+    QueueNode *first = atomic_load_explicit(&queue->head->next, memory_order_acquire);
+    QueueNode *found = first;
+    while (found != NULL && !match(arg, found->plane))
+        found = atomic_load_explicit(&found->next, memory_order_acquire);
+    if (found != NULL)
+    {
+        Plane *carry = found->plane;
+        for (QueueNode *node = first; node != found; node = atomic_load_explicit(&node->next, memory_order_acquire))
+        {
+            Plane *next = node->plane;
+            node->plane = carry;
+            carry = next;
+        }
+        found->plane = carry;
+    }
+
+    sem_post(&queue->consumer_sem);
+    return found != NULL;
+}
+
+// Destroy queue and free all nodes (no producers may be active)
+void queue_destroy(Queue *queue)
+{
+    sem_wait(&queue->consumer_sem);
+
+    QueueNode *current = queue->head;
+    while (current != NULL)
+    {
+        QueueNode *next = atomic_load_explicit(&current->next, memory_order_relaxed);
+        pool_free(&queue_node_pool, current);
+        current = next;
+    }
+
+    queue->head = NULL;
+    atomic_store(&queue->tail, NULL);
+    atomic_store(&queue->count, 0);
+
+    sem_post(&queue->consumer_sem);
+    sem_destroy(&queue->consumer_sem);
+}
@@ -1,56 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
 #include "runway.h"
 #include "gui.h"
+#include "sim.h"
+#include "pool.h"
+#include "logger.h"
+#include "eventlog.h"
+#include "sequence.h"
+#include "policy.h"
+#include "bus.h"
+#include "affinity.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
+#include <errno.h>
 
 // Global runway system instance
 RunwaySystem runway_system;
+int runway_quiet = 0;
 
 // Initialize runway system
 void runway_init(RunwaySystem *sys, int landing_duration, int takeoff_duration)
 {
     // Initialize semaphores
-    sem_init(&sys->runway_access, 0, 1);       // Binary semaphore for runway
     sem_init(&sys->console_access, 0, 1);      // Binary semaphore for console
-    sem_init(&sys->emergency_flag_sem, 0, 1);  // Binary semaphore for flag
-    sem_init(&sys->emergency_queue_sem, 0, 0); // Counting semaphore (initially 0)
-    sem_init(&sys->normal_queue_sem, 0, 0);    // Counting semaphore (initially 0)
-    sem_init(&sys->active_plane_sem, 0, 1);    // Binary semaphore for active plane
-    sem_init(&sys->completed_sem, 0, 1);       // Binary semaphore for counter
-    sem_init(&sys->preemptions_sem, 0, 1);     // Binary semaphore for preemptions
+    sem_init(&sys->sched_sem, 0, 1);           // Binary semaphore for runway table
+    sem_init(&sys->dispatch_sem, 0, 0);        // Counting semaphore (initially 0)
+
+    for (int i = 0; i < MAX_RUNWAYS; i++)
+        sem_init(&sys->runways[i].preempt_sem, 0, 0); // Counting semaphore (initially 0)
 
     // Initialize state
-    sys->emergency_flag = 0;
-    sys->active_plane = NULL;
+    runway_configure(sys, 1, NULL);
+    sys->start_ms = 0;
+    sys->dispatcher_stop = 0;
+    sys->dispatcher_running = 0;
     sys->total_planes = 0;
-    sys->planes_completed = 0;
-    sys->preemptions_count = 0;
+    stats_init(&runway_stats);
 
     // Initialize queues
     queue_init(&sys->emergency_queue);
     queue_init(&sys->normal_queue);
+    pqueue_init(&sys->waiting_heap, PRIORITY_CLASS_COUNT, 0);
+    runway_set_policy(sys, POLICY_DEFAULT);
+    sys->sequence_window = 0;
+    sys->sequence_shift = 0;
+    atomic_init(&sys->queued_seq, 0);
 
     // Set configuration
     sys->config.landing_duration = landing_duration;
     sys->config.takeoff_duration = takeoff_duration;
+    memset(sys->config.separation, 0, sizeof(sys->config.separation));
 
     runway_print_status("[SYSTEM] Runway system initialized (Landing: %ds, Takeoff: %ds)",
                         landing_duration, takeoff_duration);
 }
 
-// Thread-safe console output
+// Set up count runways; roles has one letter per runway (L = landing only,
+// T = takeoff only, M = mixed) and may be NULL for all mixed
+int runway_configure(RunwaySystem *sys, int count, const char *roles)
+{
+    if (count < 1 || count > MAX_RUNWAYS)
+        return -1;
+
+    int accepts_landing = 0, accepts_takeoff = 0;
+    for (int i = 0; i < count; i++)
+    {
+        RunwayRole role = RUNWAY_MIXED;
+        char c = (roles != NULL && roles[i] != '\0') ? roles[i] : 'M';
+        if (c == 'L' || c == 'l')
+            role = RUNWAY_LANDING_ONLY;
+        else if (c == 'T' || c == 't')
+            role = RUNWAY_TAKEOFF_ONLY;
+        else if (c != 'M' && c != 'm')
+            return -1;
+
+        accepts_landing |= (role != RUNWAY_TAKEOFF_ONLY);
+        accepts_takeoff |= (role != RUNWAY_LANDING_ONLY);
+
+        Runway *runway = &sys->runways[i];
+        runway->id = i + 1;
+        runway->role = role;
+        runway->active_plane = NULL;
+        atomic_store_explicit(&runway->active_plane_id, -1, memory_order_relaxed);
+        runway->preempt_flag = 0;
+        runway->last_operation = -1;
+        runway->preempt_requested_ns = 0;
+        runway->busy_since_ms = 0;
+        runway->busy_ms = 0;
+        runway->operations_completed = 0;
+        runway->preemptions = 0;
+    }
+
+    // Every operation type needs at least one runway that accepts it
+    if (!accepts_landing || !accepts_takeoff)
+        return -1;
+
+    sys->runway_count = count;
+    return 0;
+}
+
+const char *runway_role_to_string(RunwayRole role)
+{
+    switch (role)
+    {
+    case RUNWAY_LANDING_ONLY:
+        return "LANDING";
+    case RUNWAY_TAKEOFF_ONLY:
+        return "TAKEOFF";
+    default:
+        return "MIXED";
+    }
+}
+
+// Whether a runway's role allows the plane's operation
+int runway_accepts(Runway *runway, Plane *plane)
+{
+    if (runway->role == RUNWAY_LANDING_ONLY)
+        return plane->operation == LANDING;
+    if (runway->role == RUNWAY_TAKEOFF_ONLY)
+        return plane->operation == TAKEOFF;
+    return 1;
+}
+
+// Timestamp for a log line: wall clock, or the simulated clock in virtual-time mode
+long long runway_clock_ns()
+{
+    if (sim_virtual_mode)
+        return sim_now_ms() * 1000000LL;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Render a runway_clock_ns() timestamp as HH:MM:SS
+void runway_format_clock(long long stamp_ns, char *buffer, size_t size)
+{
+    long long secs = stamp_ns / 1000000000LL;
+    if (sim_virtual_mode)
+    {
+        snprintf(buffer, size, "%02lld:%02lld:%02lld",
+                 secs / 3600, (secs / 60) % 60, secs % 60);
+    }
+    else
+    {
+        time_t now = (time_t)secs;
+        struct tm tm_info;
+        localtime_r(&now, &tm_info);
+        strftime(buffer, size, "%H:%M:%S", &tm_info);
+    }
+}
+
+// Thread-safe console output (buffered to the logger thread when -A is on)
 void runway_print_status(const char *format, ...)
 {
+    if (runway_quiet)
+        return;
+
+    // With a subscriber printing the event lines, the status line goes through it
+    // too so that it comes out after the events published before it
+    if (BUS_WANTS(BUS_STATUS))
+    {
+        char line[512];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (bus_publish_status(&event_bus, line))
+            return;
+    }
+
+    long long stamp_ns = runway_clock_ns();
+
+    if (logger_enabled)
+    {
+        va_list args;
+        va_start(args, format);
+        int buffered = logger_vwrite(&logger, stamp_ns, format, args);
+        va_end(args);
+        if (buffered == 0)
+            return;
+    }
+
     sem_wait(&runway_system.console_access);
 
-    // Get current time
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    char time_str[9];
-    strftime(time_str, sizeof(time_str), "%H:%M:%S", tm_info);
+    char time_str[32];
+    runway_format_clock(stamp_ns, time_str, sizeof(time_str));
 
     if (gui_enabled)
     {
@@ -82,182 +220,676 @@ void runway_print_status(const char *format, ...)
     sem_post(&runway_system.console_access);
 }
 
-// Request runway access with priority scheduling
-void runway_request_access(Plane *plane)
+// Switch scheduling policy; the waiting set must still be empty
+void runway_set_policy(RunwaySystem *sys, const SchedPolicy *policy)
 {
-    plane->state = APPROACHING;
+    sys->policy = policy;
+    sys->use_priority_heap = policy->use_priority_heap;
+    sys->waiting_heap.key_fn = policy->heap_key;
+}
 
-    // Priority-based scheduling: always check emergency queue first
-    if (plane->priority == EMERGENCY)
+// Schedule waiting planes through the priority heap instead of the FIFO queues
+void runway_enable_priority_heap(RunwaySystem *sys, long long aging_ms)
+{
+    sys->waiting_heap.aging_ms = aging_ms;
+    runway_set_policy(sys, &policy_aging);
+}
+
+// Reorder the front of normal_queue for the runways (see sequence.c); a plane
+// is overtaken by at most shift later arrivals
+void runway_enable_sequencing(RunwaySystem *sys, int window, int shift)
+{
+    sys->sequence_window = (window > SEQUENCE_MAX_WINDOW) ? SEQUENCE_MAX_WINDOW : window;
+    sys->sequence_shift = shift;
+}
+
+// Stamp the first arrival and log the plane joining the waiting set;
+// returns 1 if the plane had been waiting before (a requeue)
+static int runway_note_waiting(Plane *plane, long long now_ns)
+{
+    EventLogType event = EVLOG_REQUEUED;
+    if (plane->cold->arrival_ns == PLANE_NO_TIME)
     {
-        // Emergency plane waits on emergency queue semaphore
-        sem_wait(&runway_system.emergency_queue_sem);
+        plane->cold->arrival_ns = now_ns;
+        event = EVLOG_QUEUED;
+    }
+    if (event_log_enabled)
+        eventlog_record(&event_log, now_ns, event, plane->id, -1, plane->priority_class,
+                        plane->checkpoint_progress);
+    return event == EVLOG_REQUEUED;
+}
 
-        // Try to acquire runway
-        sem_wait(&runway_system.runway_access);
+// Add a plane to the waiting set; the policy places preempted planes. A
+// requeue must hold sched_sem, since it calls into the policy.
+void runway_enqueue_waiting(RunwaySystem *sys, Plane *plane)
+{
+    int requeue = runway_note_waiting(plane, sim_now_ns());
+    stats_add(&runway_stats, plane->priority == EMERGENCY ? STAT_QUEUED_EMERGENCY : STAT_QUEUED_NORMAL, 1);
+    if (requeue)
+        POLICY_ON_REQUEUE(sys, plane);
+    else
+        runway_insert_waiting(sys, plane);
+}
 
-        // Remove self from queue
-        Plane *dequeued = queue_dequeue(&runway_system.emergency_queue);
+// Stamp the order a plane joins a FIFO queue in; the sequencer plans from it,
+// so a requeued plane counts from its requeue, not from its first arrival
+static void runway_note_queued(RunwaySystem *sys, Plane *plane)
+{
+    plane->cold->queued_seq = atomic_fetch_add_explicit(&sys->queued_seq, 1, memory_order_relaxed);
+}
 
-        runway_print_status("[GRANTED] EMERGENCY Plane %d granted runway access", plane->id);
+// Put a plane in the waiting structure (emergency/normal queue, or the priority heap)
+void runway_insert_waiting(RunwaySystem *sys, Plane *plane)
+{
+    if (sys->use_priority_heap)
+    {
+        pqueue_insert(&sys->waiting_heap, plane, sim_now_ms());
+    }
+    else if (plane->priority == EMERGENCY)
+    {
+        runway_note_queued(sys, plane);
+        queue_enqueue(&sys->emergency_queue, plane);
     }
     else
     {
-        // Normal plane waits on normal queue semaphore
-        sem_wait(&runway_system.normal_queue_sem);
+        runway_note_queued(sys, plane);
+        queue_enqueue(&sys->normal_queue, plane);
+    }
+}
 
-        // Try to acquire runway
-        sem_wait(&runway_system.runway_access);
+// A plane missing from the waiting set would never be granted and the run
+// would wait for it forever, so a batch that was not stored in full ends it
+static void runway_check_admitted(int admitted, int count)
+{
+    if (admitted == count)
+        return;
+    fprintf(stderr, "Error: Failed to queue %d of %d arriving planes\n", count - admitted, count);
+    exit(1);
+}
 
-        // Remove self from queue
-        Plane *dequeued = queue_dequeue(&runway_system.normal_queue);
+// Admit planes that arrived together: each queue (or the heap) is locked
+// once for the whole batch, the dispatcher is woken once (it fills every
+// free runway per wakeup), and observers get one event.
+void runway_admit_batch(RunwaySystem *sys, Plane **planes, int count)
+{
+    if (count <= 0)
+        return;
 
-        runway_print_status("[GRANTED] NORMAL Plane %d granted runway access", plane->id);
+    long long now_ns = sim_now_ns();
+    int emergencies = 0;
+    for (int i = 0; i < count; i++)
+    {
+        planes[i]->state = WAITING;
+        runway_note_waiting(planes[i], now_ns);
+        emergencies += (planes[i]->priority == EMERGENCY);
     }
+    stats_add(&runway_stats, STAT_QUEUED_EMERGENCY, emergencies);
+    stats_add(&runway_stats, STAT_QUEUED_NORMAL, count - emergencies);
 
-    // Set as active plane
-    sem_wait(&runway_system.active_plane_sem);
-    runway_system.active_plane = plane;
-    sem_post(&runway_system.active_plane_sem);
+    if (sys->use_priority_heap)
+    {
+        runway_check_admitted(pqueue_insert_batch(&sys->waiting_heap, planes, count, sim_now_ms()),
+                              count);
+    }
+    else
+    {
+        // Split by queue in chunks, keeping arrival order within each queue
+        Plane *chunk[RUNWAY_ADMIT_CHUNK];
+        const PriorityLevel levels[2] = {EMERGENCY, NORMAL};
+        for (int l = 0; l < 2; l++)
+        {
+            PriorityLevel level = levels[l];
+            Queue *queue = (level == EMERGENCY) ? &sys->emergency_queue : &sys->normal_queue;
+            int n = 0;
+            for (int i = 0; i < count; i++)
+            {
+                if (planes[i]->priority != level)
+                    continue;
+                runway_note_queued(sys, planes[i]);
+                chunk[n++] = planes[i];
+                if (n == RUNWAY_ADMIT_CHUNK)
+                {
+                    runway_check_admitted(queue_enqueue_batch(queue, chunk, n), n);
+                    n = 0;
+                }
+            }
+            if (n > 0)
+                runway_check_admitted(queue_enqueue_batch(queue, chunk, n), n);
+        }
+    }
+    if (sys->dispatcher_running)
+        sem_post(&sys->dispatch_sem);
 
-    // Update GUI
-    gui_update_runway(plane);
-    gui_update_queues();
+    if (count == 1)
+    {
+        BUS_PUBLISH(BUS_ARRIVAL, planes[0], -1, 0);
+        BUS_PUBLISH(BUS_QUEUED, planes[0], -1, runway_waiting_count(sys, planes[0]->priority));
+    }
+    else
+    {
+        BUS_PUBLISH_BATCH(planes[0]->id, planes[count - 1]->id, emergencies, count - emergencies,
+                          runway_waiting_count(sys, EMERGENCY), runway_waiting_count(sys, NORMAL));
+    }
 }
 
-// Perform runway operation with checkpoint support
-void runway_perform_operation(Plane *plane)
+// Number of waiting planes at a priority level
+int runway_waiting_count(RunwaySystem *sys, PriorityLevel priority)
 {
-    plane->state = USING_RUNWAY;
-    if (plane->start_time == 0)
+    if (sys->use_priority_heap)
     {
-        plane->start_time = time(NULL);
+        int count = 0;
+        for (int c = 0; c < PRIORITY_CLASS_COUNT; c++)
+        {
+            if (priority_class_level(c) == priority)
+                count += pqueue_level_count(&sys->waiting_heap, c);
+        }
+        return count;
     }
+    return queue_get_count(priority == EMERGENCY ? &sys->emergency_queue : &sys->normal_queue);
+}
 
-    // Determine operation duration
-    int duration = (plane->operation == LANDING) ? runway_system.config.landing_duration : runway_system.config.takeoff_duration;
+// Whether an emergency is next in line and should preempt normal traffic.
+// With aging, a long-waiting normal plane can rank ahead of a new emergency.
+int runway_emergency_waiting(RunwaySystem *sys)
+{
+    if (sys->use_priority_heap)
+    {
+        Plane *top = pqueue_peek(&sys->waiting_heap);
+        return top != NULL && priority_class_level(top->priority_class) == EMERGENCY;
+    }
+    return !queue_is_empty(&sys->emergency_queue);
+}
 
-    // Calculate remaining duration based on checkpoint
-    int elapsed_time = (duration * plane->checkpoint_progress) / 100;
-    int remaining_time = duration - elapsed_time;
+// Copy one waiting plane's displayed fields (called with its queue locked)
+static void runway_copy_waiting(void *arg, Plane *plane)
+{
+    WaitingPlane **next = (WaitingPlane **)arg;
+    WaitingPlane *copy = (*next)++;
+    copy->id = plane->id;
+    copy->priority_class = plane->priority_class;
+    copy->operation = plane->operation;
+    copy->checkpoint_progress = plane->checkpoint_progress;
+    copy->arrival_ns = plane->cold->arrival_ns;
+}
 
-    if (plane->checkpoint_progress > 0)
+// Copy up to max waiting planes at a priority level (for display). Only
+// values are returned: a plane may be granted and freed as soon as its queue
+// is unlocked.
+int runway_waiting_snapshot(RunwaySystem *sys, PriorityLevel priority, WaitingPlane *planes, int max)
+{
+    WaitingPlane *next = planes;
+    if (sys->use_priority_heap)
     {
-        runway_print_status("[RESUME] Plane %d resuming %s from %d%% (remaining: %ds)",
-                            plane->id,
-                            operation_to_string(plane->operation),
-                            plane->checkpoint_progress,
-                            remaining_time);
+        if (priority == EMERGENCY)
+            return pqueue_visit(&sys->waiting_heap, 0, CLASS_SCHEDULED - 1, max, runway_copy_waiting, &next);
+        return pqueue_visit(&sys->waiting_heap, CLASS_SCHEDULED, PRIORITY_CLASS_COUNT - 1, max,
+                            runway_copy_waiting, &next);
     }
-    else
+    return queue_visit(priority == EMERGENCY ? &sys->emergency_queue : &sys->normal_queue, max,
+                       runway_copy_waiting, &next);
+}
+
+// Plan the next stretch of normal traffic for a free runway and write the
+// planned order back into normal_queue (caller holds sched_sem)
+void runway_resequence(RunwaySystem *sys, Runway *runway)
+{
+    Plane *window[SEQUENCE_MAX_WINDOW];
+    int n = queue_snapshot(&sys->normal_queue, window, sys->sequence_window);
+    if (n < 2)
+        return;
+
+    // Earlier plans reordered the queue; plan from the order planes joined it again
+    for (int i = 1; i < n; i++)
     {
-        runway_print_status("[OPERATION] Plane %d starting %s (duration: %ds)",
-                            plane->id,
-                            operation_to_string(plane->operation),
-                            duration);
+        Plane *plane = window[i];
+        int j = i - 1;
+        while (j >= 0 && window[j]->cold->queued_seq > plane->cold->queued_seq)
+        {
+            window[j + 1] = window[j];
+            j--;
+        }
+        window[j + 1] = plane;
     }
 
-    // Perform operation with slower checkpoint checking (every 800ms for better visualization)
-    int checkpoint_interval_ms = 800;
-    int total_intervals = (remaining_time * 1000) / checkpoint_interval_ms;
+    SequenceEstimate estimate;
+    sequence_plan(window, n, runway->last_operation, &sys->config, sys->sequence_shift, &estimate);
+    queue_reorder(&sys->normal_queue, window, n);
+
+    stats_add(&runway_stats, STAT_SEQ_PLANS, 1);
+    stats_add(&runway_stats, STAT_SEQ_FIFO_SPAN_MS, estimate.fifo_span_ms);
+    stats_add(&runway_stats, STAT_SEQ_PLAN_SPAN_MS, estimate.plan_span_ms);
+    stats_add(&runway_stats, STAT_SEQ_FIFO_COMPLETION_MS, estimate.fifo_completion_ms);
+    stats_add(&runway_stats, STAT_SEQ_PLAN_COMPLETION_MS, estimate.plan_completion_ms);
+}
 
-    for (int i = 0; i < total_intervals; i++)
+// Charge the planes still in the sequencing window that joined normal_queue
+// before the plane just granted from it with being overtaken (caller holds
+// sched_sem). The runway may not take the head of the plan, so this counts
+// against the plane it actually got.
+void runway_note_overtaking(RunwaySystem *sys, Plane *granted)
+{
+    Plane *window[SEQUENCE_MAX_WINDOW];
+    int n = queue_snapshot(&sys->normal_queue, window, sys->sequence_window);
+    int overtook = 0;
+    for (int i = 0; i < n; i++)
     {
-        usleep(checkpoint_interval_ms * 1000); // Sleep for 800ms
+        if (window[i]->cold->queued_seq < granted->cold->queued_seq)
+        {
+            window[i]->cold->overtaken++;
+            overtook = 1;
+        }
+    }
+    if (overtook)
+        stats_add(&runway_stats, STAT_SEQ_REORDERS, 1);
+}
 
-        // Update checkpoint progress
-        plane->checkpoint_progress = elapsed_time +
-                                     ((i + 1) * checkpoint_interval_ms * 100) / (duration * 1000);
-        if (plane->checkpoint_progress > 100)
-            plane->checkpoint_progress = 100;
+// Pick the next plane for a free runway (see policy.c)
+Plane *runway_select_next(RunwaySystem *sys, Runway *runway)
+{
+    return POLICY_SELECT_NEXT(sys, runway);
+}
 
-        // Update GUI runway display
-        gui_update_runway(plane);
+// Next emergency in line (for choosing a runway to preempt)
+static Plane *runway_peek_emergency(RunwaySystem *sys)
+{
+    if (sys->use_priority_heap)
+        return pqueue_peek(&sys->waiting_heap);
+    return queue_peek(&sys->emergency_queue);
+}
 
-        // Check for emergency preemption (only for normal planes)
-        if (plane->priority == NORMAL)
-        {
-            sem_wait(&runway_system.emergency_flag_sem);
-            int emergency_pending = runway_system.emergency_flag;
-            sem_post(&runway_system.emergency_flag_sem);
+// Assign every free runway to the next compatible waiting plane, then ask
+// runways held by normal planes to yield if emergencies are still waiting
+// and the policy finds the preemption worthwhile.
+// Caller holds sched_sem.
+// Returns the number of planes written to granted.
+int runway_dispatch(RunwaySystem *sys, Plane **granted, int max)
+{
+    int n = 0;
+    long long now = sim_now_ms();
+    long long now_ns = sim_now_ns();
 
-            if (emergency_pending)
+    for (int i = 0; i < sys->runway_count && n < max; i++)
+    {
+        Runway *runway = &sys->runways[i];
+        if (runway->active_plane != NULL)
+            continue;
+
+        Plane *next = runway_select_next(sys, runway);
+        if (next == NULL)
+            continue;
+
+        runway->active_plane = next;
+        atomic_store_explicit(&runway->active_plane_id, next->id, memory_order_relaxed);
+        runway->preempt_flag = 0;
+        while (sem_trywait(&runway->preempt_sem) == 0)
+            ; // Drop wakeups meant for the previous plane
+        runway->busy_since_ms = now;
+        next->runway_id = i;
+        granted[n++] = next;
+        stats_add(&runway_stats, next->priority == EMERGENCY ? STAT_GRANTS_EMERGENCY : STAT_GRANTS_NORMAL, 1);
+        stats_add(&runway_stats, next->priority == EMERGENCY ? STAT_QUEUED_EMERGENCY : STAT_QUEUED_NORMAL, -1);
+        PlaneCold *cold = next->cold;
+        cold->granted_ns = now_ns;
+        if (cold->first_grant_ns == PLANE_NO_TIME)
+        {
+            // Separation behind the runway's previous operation extends this one
+            if (runway->last_operation >= 0)
             {
-                // Save checkpoint and yield runway
-                plane->state = INTERRUPTED;
+                cold->separation = sys->config.separation[runway->last_operation][next->operation];
+                stats_add(&runway_stats, STAT_SEPARATION_MS, cold->separation * 1000L);
+            }
+            cold->first_grant_ns = now_ns;
+            stats_record_wait(&runway_stats, next->priority == EMERGENCY, (now_ns - cold->arrival_ns) / 1000000);
+        }
+        if (cold->preempted_ns != PLANE_NO_TIME)
+        {
+            cold->preempt_overhead_ns += now_ns - cold->preempted_ns;
+            cold->preempted_ns = PLANE_NO_TIME;
+        }
+        runway->last_operation = next->operation;
+        if (event_log_enabled)
+            eventlog_record(&event_log, now_ns, EVLOG_GRANTED, next->id, i, next->priority_class,
+                            next->checkpoint_progress);
+    }
+
+    // Keep one preemption request per waiting emergency that has no runway yet
+    int waiting = runway_emergency_waiting(sys) ? runway_waiting_count(sys, EMERGENCY) : 0;
+    int pending = 0;
+    for (int i = 0; i < sys->runway_count; i++)
+        pending += sys->runways[i].preempt_flag;
+
+    Plane *emergency = runway_peek_emergency(sys);
+    for (int i = 0; i < sys->runway_count && pending != waiting; i++)
+    {
+        Runway *runway = &sys->runways[i];
+        if (pending > waiting && runway->preempt_flag)
+        {
+            // Emergency was served elsewhere; withdraw the stale request
+            runway->preempt_flag = 0;
+            pending--;
+        }
+        else if (pending < waiting && !runway->preempt_flag && runway->active_plane != NULL &&
+                 runway->active_plane->priority == NORMAL &&
+                 (emergency == NULL ||
+                  (runway_accepts(runway, emergency) && POLICY_SHOULD_PREEMPT(sys, runway, emergency))))
+        {
+            runway->preempt_flag = 1;
+            runway->preempt_requested_ns = sim_now_ns();
+            sem_post(&runway->preempt_sem); // Interrupt the active plane's checkpoint wait
+            pending++;
+        }
+    }
 
-                runway_print_status("[PREEMPTED] Plane %d interrupted at %d%% - yielding to emergency",
-                                    plane->id, plane->checkpoint_progress);
+    return n;
+}
 
-                // Increment preemption counter
-                sem_wait(&runway_system.preemptions_sem);
-                runway_system.preemptions_count++;
-                sem_post(&runway_system.preemptions_sem);
+// Take a plane off its runway and account busy time (caller holds sched_sem)
+void runway_vacate(RunwaySystem *sys, Plane *plane)
+{
+    if (plane->runway_id < 0)
+        return;
 
-                // Clear active plane
-                sem_wait(&runway_system.active_plane_sem);
-                runway_system.active_plane = NULL;
-                sem_post(&runway_system.active_plane_sem);
+    Runway *runway = &sys->runways[plane->runway_id];
+    long long busy = sim_now_ms() - runway->busy_since_ms;
+    runway->busy_ms += busy;
+    stats_add(&runway_stats, STAT_RUNWAY_BUSY_MS, busy);
+
+    long long now_ns = sim_now_ns();
+    plane->cold->service_ns += now_ns - plane->cold->granted_ns;
+    if (plane->state == INTERRUPTED)
+    {
+        runway->preemptions++;
+        plane->cold->preempted_ns = now_ns;
+        plane->cold->preemptions++;
+
+        long long latency = sim_now_ns() - runway->preempt_requested_ns;
+        stats_add(&runway_stats, STAT_PREEMPTIONS, 1);
+        stats_add(&runway_stats, STAT_PREEMPT_LATENCY_NS, latency);
+        stats_max(&runway_stats, STAT_PREEMPT_LATENCY_MAX_NS, latency);
+    }
+    else
+        runway->operations_completed++;
+    if (event_log_enabled)
+        eventlog_record(&event_log, now_ns, plane->state == INTERRUPTED ? EVLOG_PREEMPTED : EVLOG_RELEASED,
+                        plane->id, plane->runway_id, plane->priority_class, plane->checkpoint_progress);
+    runway->active_plane = NULL;
+    atomic_store_explicit(&runway->active_plane_id, -1, memory_order_relaxed);
+    runway->preempt_flag = 0;
+    plane->runway_id = -1;
+}
 
-                // Update GUI
-                gui_update_runway(NULL);
-                gui_update_stats();
+// Dispatcher thread: on every arrival, release or preemption, hands free
+// runways to exactly the selected planes
+static void *runway_dispatcher(void *arg)
+{
+    RunwaySystem *sys = (RunwaySystem *)arg;
+    Plane *granted[MAX_RUNWAYS];
 
-                // Release runway
-                sem_post(&runway_system.runway_access);
+    affinity_apply(&affinity, AFFINITY_DISPATCHER);
+    while (1)
+    {
+        sem_wait(&sys->dispatch_sem);
+        if (sys->dispatcher_stop)
+            break;
 
-                // Clear emergency flag
-                sem_wait(&runway_system.emergency_flag_sem);
-                runway_system.emergency_flag = 0;
-                sem_post(&runway_system.emergency_flag_sem);
+        sem_wait(&sys->sched_sem);
+        int n = runway_dispatch(sys, granted, MAX_RUNWAYS);
+        sem_post(&sys->sched_sem);
 
-                // Re-enqueue to normal queue
-                queue_enqueue(&runway_system.normal_queue, plane);
-                sem_post(&runway_system.normal_queue_sem);
+        // Per-plane handoff: wake only the selected planes
+        for (int i = 0; i < n; i++)
+            sem_post(&granted[i]->cold->resume_sem);
+    }
 
-                runway_print_status("[REQUEUE] Plane %d re-queued to NORMAL queue with checkpoint at %d%%",
-                                    plane->id, plane->checkpoint_progress);
+    pool_thread_flush();
+    logger_thread_release(&logger);
+    return NULL;
+}
 
-                // Update GUI queues
-                gui_update_queues();
-                runway_perform_operation(plane);
-                return;
-            }
+// Start the central dispatcher used by thread-per-plane mode
+void runway_start_dispatcher(RunwaySystem *sys)
+{
+    sys->dispatcher_stop = 0;
+    sys->start_ms = sim_now_ms();
+    if (pthread_create(&sys->dispatcher_thread, NULL, runway_dispatcher, sys) != 0)
+    {
+        perror("Failed to create dispatcher thread");
+        return;
+    }
+    sys->dispatcher_running = 1;
+}
+
+// Stop the dispatcher once all planes have released the runway
+void runway_stop_dispatcher(RunwaySystem *sys)
+{
+    sys->dispatcher_running = 0;
+    sys->dispatcher_stop = 1;
+    sem_post(&sys->dispatch_sem);
+    pthread_join(sys->dispatcher_thread, NULL);
+}
+
+// Request runway access: wait for the dispatcher to hand over the runway
+void runway_request_access(Plane *plane)
+{
+    plane->state = APPROACHING;
+
+    // The dispatcher picks planes in priority order and posts their resume semaphore
+    sem_wait(&plane->cold->resume_sem);
+
+    BUS_PUBLISH(BUS_GRANTED, plane, plane->runway_id, 0);
+}
+
+// Sleep until deadline_ms (sim_now_ms clock) or until the runway's preemption
+// request is raised. Returns 1 if woken by a request, 0 on timeout.
+static int runway_wait_preempt(Runway *runway, long long deadline_ms)
+{
+    long long wait_ms = deadline_ms - sim_now_ms();
+    if (wait_ms < 0)
+        wait_ms = 0;
+
+    struct timespec abs_timeout;
+    clock_gettime(CLOCK_REALTIME, &abs_timeout);
+    abs_timeout.tv_sec += wait_ms / 1000;
+    abs_timeout.tv_nsec += (wait_ms % 1000) * 1000000L;
+    if (abs_timeout.tv_nsec >= 1000000000L)
+    {
+        abs_timeout.tv_sec++;
+        abs_timeout.tv_nsec -= 1000000000L;
+    }
+
+    while (sem_timedwait(&runway->preempt_sem, &abs_timeout) != 0)
+    {
+        if (errno != EINTR)
+            return 0;
+    }
+    return 1;
+}
+
+// Runway occupancy in seconds for the plane's operation type, including any
+// separation behind the previous operation
+int runway_operation_duration(Plane *plane)
+{
+    int separation = plane->cold->separation;
+    if (plane->duration > 0)
+        return plane->duration + separation;
+    return separation +
+           ((plane->operation == LANDING) ? runway_system.config.landing_duration : runway_system.config.takeoff_duration);
+}
+
+// Use the runway from the plane's checkpoint until the operation is done
+// (returns 0) or an emergency preempts it (returns 1, plane requeued)
+static int runway_run_grant(Plane *plane)
+{
+    plane->state = USING_RUNWAY;
+
+    // Determine operation duration
+    int duration = runway_operation_duration(plane);
+
+    // Calculate remaining duration based on checkpoint
+    int elapsed_ms = (duration * 1000 * plane->checkpoint_progress) / 100;
+    int remaining_time = duration - elapsed_ms / 1000;
+
+    BUS_PUBLISH(BUS_STARTED, plane, plane->runway_id, plane->checkpoint_progress > 0 ? remaining_time : duration);
+
+    // Run until the operation is done, updating progress every checkpoint.
+    // A preemption request posts the runway's preempt_sem and ends the wait at once.
+    Runway *runway = &runway_system.runways[plane->runway_id];
+    long long duration_ms = (long long)duration * 1000;
+    long long start_ms = sim_now_ms();
+    long long end_ms = start_ms + duration_ms - elapsed_ms;
+    long long checkpoint_ms = start_ms + CHECKPOINT_INTERVAL_MS;
+
+    while (1)
+    {
+        long long deadline_ms = (checkpoint_ms < end_ms) ? checkpoint_ms : end_ms;
+        int woken = runway_wait_preempt(runway, deadline_ms);
+        long long now_ms = sim_now_ms();
+
+        // Update checkpoint progress
+        plane->checkpoint_progress = (int)(((elapsed_ms + now_ms - start_ms) * 100) / duration_ms);
+        if (plane->checkpoint_progress > 100)
+            plane->checkpoint_progress = 100;
+        if (!woken)
+        {
+            checkpoint_ms += CHECKPOINT_INTERVAL_MS;
+            BUS_PUBLISH(BUS_CHECKPOINT, plane, plane->runway_id, 0);
+        }
+
+        // Check this runway's preemption signal (only set for normal planes);
+        // a wakeup whose request was withdrawn just keeps waiting
+        sem_wait(&runway_system.sched_sem);
+        int preempt = runway->preempt_flag && now_ms < end_ms;
+        if (preempt)
+        {
+            // Save checkpoint and leave the runway
+            plane->state = INTERRUPTED;
+            runway_vacate(&runway_system, plane);
+
+            // Rejoin the waiting set before the dispatcher can look at it again,
+            // so the policy's on_requeue runs under sched_sem like its other callbacks
+            plane->state = WAITING;
+            runway_enqueue_waiting(&runway_system, plane);
+        }
+        sem_post(&runway_system.sched_sem);
+
+        if (preempt)
+        {
+            BUS_PUBLISH(BUS_PREEMPTED, plane, -1, 0);
+
+            // Let the dispatcher hand the runway over
+            stats_add(&runway_stats, STAT_REQUEUES, 1);
+            sem_post(&runway_system.dispatch_sem);
+            BUS_PUBLISH(BUS_REQUEUED, plane, -1, 0);
+            return 1;
         }
+
+        if (now_ms >= end_ms)
+            return 0;
     }
+}
+
+// Perform runway operation with checkpoint support
+void runway_perform_operation(Plane *plane)
+{
+    // After each preemption wait for the next grant and resume from the checkpoint
+    while (runway_run_grant(plane))
+        runway_request_access(plane);
 
     // Operation completed
     plane->checkpoint_progress = 100;
-    runway_print_status("[FINISHED] Plane %d completed %s operation",
-                        plane->id, operation_to_string(plane->operation));
+    BUS_PUBLISH(BUS_FINISHED, plane, plane->runway_id, 0);
 }
 
 // Release runway
 void runway_release(Plane *plane)
 {
-    // Clear active plane
-    sem_wait(&runway_system.active_plane_sem);
-    runway_system.active_plane = NULL;
-    sem_post(&runway_system.active_plane_sem);
+    int runway_id = plane->runway_id;
 
-    // Release runway semaphore
-    sem_post(&runway_system.runway_access);
+    // Clear active plane and let the dispatcher reassign the runway
+    sem_wait(&runway_system.sched_sem);
+    runway_vacate(&runway_system, plane);
+    sem_post(&runway_system.sched_sem);
+    sem_post(&runway_system.dispatch_sem);
 
-    runway_print_status("[RELEASE] Plane %d released runway", plane->id);
-
-    // Update GUI
-    gui_update_runway(NULL);
-    gui_update_stats();
+    BUS_PUBLISH(BUS_RELEASED, plane, runway_id, 0);
 }
 
 // Display final statistics
 void runway_display_stats()
 {
+    // Make room so the summary is never dropped by the async logger
+    if (logger_enabled)
+        logger_drain(&logger);
+
     runway_print_status("\n========== SIMULATION STATISTICS ==========");
-    runway_print_status("Total Planes Processed: %d", runway_system.planes_completed);
-    runway_print_status("Emergency Preemptions: %d", runway_system.preemptions_count);
-    runway_print_status("Emergency Queue Final: %d", queue_get_count(&runway_system.emergency_queue));
-    runway_print_status("Normal Queue Final: %d", queue_get_count(&runway_system.normal_queue));
+    long preemptions = stats_read(&runway_stats, STAT_PREEMPTIONS);
+    runway_print_status("Total Planes Processed: %ld", stats_read(&runway_stats, STAT_PLANES_COMPLETED));
+    runway_print_status("Emergency Preemptions: %ld", preemptions);
+    if (preemptions > 0)
+    {
+        runway_print_status("Preemption Latency: avg %.3fms, max %.3fms (%ld preemptions)",
+                            stats_read(&runway_stats, STAT_PREEMPT_LATENCY_NS) / 1e6 / preemptions,
+                            stats_read(&runway_stats, STAT_PREEMPT_LATENCY_MAX_NS) / 1e6,
+                            preemptions);
+    }
+    runway_print_status("Grants: %ld emergency, %ld normal; Re-queues: %ld",
+                        stats_read(&runway_stats, STAT_GRANTS_EMERGENCY),
+                        stats_read(&runway_stats, STAT_GRANTS_NORMAL),
+                        stats_read(&runway_stats, STAT_REQUEUES));
+    runway_print_status("Wait Before Grant: emergency avg %.0fms, p99 %lldms; normal avg %.0fms, p99 %lldms",
+                        stats_wait_mean_ms(&runway_stats, 1), stats_wait_percentile_ms(&runway_stats, 1, 99.0),
+                        stats_wait_mean_ms(&runway_stats, 0), stats_wait_percentile_ms(&runway_stats, 0, 99.0));
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++)
+    {
+        if (stats_class_planes(&runway_stats, c) == 0)
+            continue;
+        runway_print_status("%s (%ld planes): wait avg %.3fms max %.3fms; service avg %.3fms; "
+                            "preemption overhead avg %.3fms max %.3fms (%ld preemptions)",
+                            priority_class_to_string(c), stats_class_planes(&runway_stats, c),
+                            stats_phase_mean_ns(&runway_stats, c, PHASE_QUEUE_WAIT) / 1e6,
+                            stats_phase_max_ns(&runway_stats, c, PHASE_QUEUE_WAIT) / 1e6,
+                            stats_phase_mean_ns(&runway_stats, c, PHASE_SERVICE) / 1e6,
+                            stats_phase_mean_ns(&runway_stats, c, PHASE_PREEMPT_OVERHEAD) / 1e6,
+                            stats_phase_max_ns(&runway_stats, c, PHASE_PREEMPT_OVERHEAD) / 1e6,
+                            stats_class_preemptions(&runway_stats, c));
+    }
+    runway_print_status("Total Runway Busy Time: %.1fs", stats_read(&runway_stats, STAT_RUNWAY_BUSY_MS) / 1000.0);
+    if (stats_read(&runway_stats, STAT_SEPARATION_MS) > 0)
+    {
+        runway_print_status("Separation Time: %.1fs", stats_read(&runway_stats, STAT_SEPARATION_MS) / 1000.0);
+    }
+    if (runway_system.sequence_window > 1)
+    {
+        long plans = stats_read(&runway_stats, STAT_SEQ_PLANS);
+        long fifo_span = stats_read(&runway_stats, STAT_SEQ_FIFO_SPAN_MS);
+        long plan_span = stats_read(&runway_stats, STAT_SEQ_PLAN_SPAN_MS);
+        long fifo_completion = stats_read(&runway_stats, STAT_SEQ_FIFO_COMPLETION_MS);
+        long plan_completion = stats_read(&runway_stats, STAT_SEQ_PLAN_COMPLETION_MS);
+        runway_print_status("Sequencing (window %d, shift %d): %ld plans, %ld grants out of arrival order",
+                            runway_system.sequence_window, runway_system.sequence_shift, plans,
+                            stats_read(&runway_stats, STAT_SEQ_REORDERS));
+        runway_print_status("Sequencing vs FIFO: window throughput %+.1f%%, total completion time %+.1f%%",
+                            plan_span > 0 ? 100.0 * fifo_span / plan_span - 100.0 : 0.0,
+                            fifo_completion > 0 ? 100.0 * plan_completion / fifo_completion - 100.0 : 0.0);
+    }
+    runway_print_status("Emergency Queue Final: %d", runway_waiting_count(&runway_system, EMERGENCY));
+    runway_print_status("Normal Queue Final: %d", runway_waiting_count(&runway_system, NORMAL));
+
+    long long elapsed_ms = sim_now_ms() - runway_system.start_ms;
+    for (int i = 0; i < runway_system.runway_count; i++)
+    {
+        Runway *runway = &runway_system.runways[i];
+        runway_print_status("Runway %d (%s): %d operations, %d preemptions, %.1f%% utilization",
+                            runway->id, runway_role_to_string(runway->role),
+                            runway->operations_completed, runway->preemptions,
+                            elapsed_ms > 0 ? 100.0 * runway->busy_ms / elapsed_ms : 0.0);
+    }
+    runway_print_status("Plane Pool: %ld allocs, peak %ld in use, %ld slabs",
+                        atomic_load(&plane_pool.allocs), atomic_load(&plane_pool.peak_in_use),
+                        atomic_load(&plane_pool.slab_count));
+    runway_print_status("Queue Node Pool: %ld allocs, peak %ld in use, %ld slabs",
+                        atomic_load(&queue_node_pool.allocs), atomic_load(&queue_node_pool.peak_in_use),
+                        atomic_load(&queue_node_pool.slab_count));
     runway_print_status("===========================================\n");
 }
 
@@ -269,16 +901,14 @@ void runway_destroy(RunwaySystem *sys)
     // Destroy queues
     queue_destroy(&sys->emergency_queue);
     queue_destroy(&sys->normal_queue);
+    pqueue_destroy(&sys->waiting_heap);
 
     // Destroy semaphores
-    sem_destroy(&sys->runway_access);
     sem_destroy(&sys->console_access);
-    sem_destroy(&sys->emergency_flag_sem);
-    sem_destroy(&sys->emergency_queue_sem);
-    sem_destroy(&sys->normal_queue_sem);
-    sem_destroy(&sys->active_plane_sem);
-    sem_destroy(&sys->completed_sem);
-    sem_destroy(&sys->preemptions_sem);
+    sem_destroy(&sys->sched_sem);
+    sem_destroy(&sys->dispatch_sem);
+    for (int i = 0; i < MAX_RUNWAYS; i++)
+        sem_destroy(&sys->runways[i].preempt_sem);
 
     runway_print_status("[SYSTEM] Runway system shutdown complete");
 }
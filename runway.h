@@ -1,52 +1,129 @@
 #ifndef RUNWAY_H
 #define RUNWAY_H
 
+#include <stddef.h>
+#include <stdatomic.h>
 #include <semaphore.h>
 #include "plane.h"
 #include "queue.h"
+#include "pqueue.h"
+#include "stats.h"
+
+// Interval between progress checkpoints while a plane holds the runway
+// (preemption requests interrupt the wait at once in thread-per-plane mode)
+#define CHECKPOINT_INTERVAL_MS 800
+
+#define MAX_RUNWAYS 16
+#define RUNWAY_ADMIT_CHUNK 128 // Planes linked per queue lock in a batch admission
+
+// Scheduling policy (policy.h)
+struct SchedPolicy;
 
 // Runway configuration
 typedef struct
 {
     int landing_duration; // seconds
     int takeoff_duration; // seconds
+    int separation[2][2]; // seconds between a [leader] and [follower] OperationType
 } RunwayConfig;
 
+// Displayed fields of a waiting plane, copied while its queue is locked
+typedef struct
+{
+    int id;
+    int priority_class;
+    OperationType operation;
+    int checkpoint_progress;
+    long long arrival_ns;
+} WaitingPlane;
+
+// Operations a runway accepts
+typedef enum
+{
+    RUNWAY_MIXED,
+    RUNWAY_LANDING_ONLY,
+    RUNWAY_TAKEOFF_ONLY
+} RunwayRole;
+
+// Per-runway state (protected by RunwaySystem.sched_sem)
+typedef struct
+{
+    int id;
+    RunwayRole role;
+    Plane *active_plane;      // Currently using this runway
+    atomic_int active_plane_id; // Id of active_plane for lock-free readers (-1 when idle)
+    int preempt_flag;         // Asks the active plane to yield to an emergency
+    sem_t preempt_sem;        // Posted when preempt_flag is raised (wakes the active plane)
+    long long preempt_requested_ns; // sim_now_ns() when preempt_flag was raised
+    long long busy_since_ms;  // When the active plane was granted
+    long long busy_ms;        // Total occupied time
+    int operations_completed;
+    int preemptions;
+    int last_operation;       // OperationType of the latest grant (-1 before the first)
+} Runway;
+
 // Global runway state
 typedef struct
 {
-    sem_t runway_access;       // Binary semaphore for runway access
     sem_t console_access;      // Binary semaphore for console output
-    sem_t emergency_flag_sem;  // Binary semaphore to protect emergency flag
-    sem_t emergency_queue_sem; // Counting semaphore for emergency queue
-    sem_t normal_queue_sem;    // Counting semaphore for normal queue
+    sem_t sched_sem;           // Binary semaphore protecting runway table
+    sem_t dispatch_sem;        // Counting semaphore: arrivals/releases pending dispatch
+
+    Runway runways[MAX_RUNWAYS];
+    int runway_count;
+    long long start_ms;        // Clock origin for utilization
 
-    int emergency_flag;     // Flag to signal active plane to yield
-    Plane *active_plane;    // Currently using runway
-    sem_t active_plane_sem; // Protect active_plane pointer
+    pthread_t dispatcher_thread; // Grants runways in priority order
+    int dispatcher_stop;         // Set to shut the dispatcher down
+    int dispatcher_running;      // Admissions post dispatch_sem only while set
 
     Queue emergency_queue;
     Queue normal_queue;
+    PQueue waiting_heap;   // Replaces both queues when priority heap scheduling is on
+    int use_priority_heap;
+    const struct SchedPolicy *policy; // Picks planes for free runways and decides preemption
+    int sequence_window;   // normal_queue planes the sequencer may reorder (0 = FIFO)
+    int sequence_shift;    // Most later arrivals a plane may be sequenced behind
+    atomic_ulong queued_seq; // Next PlaneCold.queued_seq: the order planes join the queues
 
     RunwayConfig config;
 
-    int total_planes;
-    int planes_completed;
-    sem_t completed_sem; // Protect planes_completed counter
-    int preemptions_count;
-    sem_t preemptions_sem; // Protect preemptions_count
+    int total_planes;   // Counters live in runway_stats (stats.h)
 } RunwaySystem;
 
 // Global runway system instance
 extern RunwaySystem runway_system;
+extern int runway_quiet; // Suppress runway_print_status output (benchmarks)
 
 // Runway functions
 void runway_init(RunwaySystem *sys, int landing_duration, int takeoff_duration);
 void runway_destroy(RunwaySystem *sys);
+int runway_configure(RunwaySystem *sys, int count, const char *roles);
+int runway_accepts(Runway *runway, Plane *plane);
+int runway_dispatch(RunwaySystem *sys, Plane **granted, int max);
+void runway_vacate(RunwaySystem *sys, Plane *plane);
+const char *runway_role_to_string(RunwayRole role);
+void runway_start_dispatcher(RunwaySystem *sys);
+void runway_stop_dispatcher(RunwaySystem *sys);
+void runway_set_policy(RunwaySystem *sys, const struct SchedPolicy *policy);
+void runway_enable_priority_heap(RunwaySystem *sys, long long aging_ms);
+void runway_enable_sequencing(RunwaySystem *sys, int window, int shift);
+void runway_enqueue_waiting(RunwaySystem *sys, Plane *plane);
+void runway_insert_waiting(RunwaySystem *sys, Plane *plane);
+void runway_admit_batch(RunwaySystem *sys, Plane **planes, int count);
+int runway_waiting_count(RunwaySystem *sys, PriorityLevel priority);
+int runway_emergency_waiting(RunwaySystem *sys);
+int runway_waiting_snapshot(RunwaySystem *sys, PriorityLevel priority, WaitingPlane *planes, int max);
+void runway_resequence(RunwaySystem *sys, Runway *runway);
+void runway_note_overtaking(RunwaySystem *sys, Plane *granted);
+Plane *runway_select_next(RunwaySystem *sys, Runway *runway);
 void runway_request_access(Plane *plane);
 void runway_perform_operation(Plane *plane);
 void runway_release(Plane *plane);
 void runway_print_status(const char *format, ...);
+long long runway_clock_ns();
+void runway_format_clock(long long stamp_ns, char *buffer, size_t size);
+int runway_operation_duration(Plane *plane);
 void runway_display_stats();
 
 #endif // RUNWAY_H
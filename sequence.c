@@ -0,0 +1,94 @@
+#include "sequence.h"
+#include <string.h>
+
+// Runway time the plane needs after a leader operation (-1 for none): what is
+// left of its operation, plus the pair's separation if it was never granted.
+// Planes that already hold a separation keep it.
+long long sequence_occupancy_ms(const RunwayConfig *config, int leader, Plane *plane)
+{
+    long long duration_ms = (long long)runway_operation_duration(plane) * 1000;
+    long long remaining_ms = duration_ms * (100 - plane->checkpoint_progress) / 100;
+    if (leader >= 0 && plane->cold->first_grant_ns == PLANE_NO_TIME)
+        remaining_ms += config->separation[leader][plane->operation] * 1000LL;
+    return remaining_ms;
+}
+
+// Finish time of the last plane and summed completion times of an order
+static void sequence_cost(Plane **order, int count, int last_operation, const RunwayConfig *config,
+                          long long *span_ms, long long *completion_ms)
+{
+    long long clock_ms = 0, total_ms = 0;
+    int leader = last_operation;
+    for (int i = 0; i < count; i++)
+    {
+        clock_ms += sequence_occupancy_ms(config, leader, order[i]);
+        total_ms += clock_ms;
+        leader = order[i]->operation;
+    }
+    *span_ms = clock_ms;
+    *completion_ms = total_ms;
+}
+
+// Reorder a window of waiting planes to minimize their total completion time.
+// planes comes in arrival order and leaves in the planned order. Planes are
+// inserted one at a time, in arrival order, at the cheapest position of the
+// partial sequence, subject to a constrained position shift: no plane may end
+// up behind more than max_shift later arrivals, counting the ones that were
+// already granted ahead of it. Returns 1 if the order changed.
+int sequence_plan(Plane **planes, int count, int last_operation, const RunwayConfig *config,
+                  int max_shift, SequenceEstimate *estimate)
+{
+    if (count > SEQUENCE_MAX_WINDOW)
+        count = SEQUENCE_MAX_WINDOW;
+
+    long long span_ms, completion_ms;
+    sequence_cost(planes, count, last_operation, config, &span_ms, &completion_ms);
+    estimate->fifo_span_ms = span_ms;
+    estimate->fifo_completion_ms = completion_ms;
+
+    Plane *order[SEQUENCE_MAX_WINDOW];
+    Plane *candidate[SEQUENCE_MAX_WINDOW];
+    int shifted[SEQUENCE_MAX_WINDOW]; // Later arrivals placed ahead, per position in order
+    int length = 0;
+    for (int i = 0; i < count; i++)
+    {
+        // Appending keeps arrival order and is always allowed
+        int best = length;
+        order[length] = planes[i];
+        sequence_cost(order, length + 1, last_operation, config, &span_ms, &completion_ms);
+        long long best_cost = completion_ms;
+
+        for (int p = length - 1; p >= 0; p--)
+        {
+            // Everything from p on would be overtaken once more
+            if (shifted[p] + 1 + order[p]->cold->overtaken > max_shift)
+                break;
+
+            memcpy(candidate, order, p * sizeof(Plane *));
+            candidate[p] = planes[i];
+            memcpy(candidate + p + 1, order + p, (length - p) * sizeof(Plane *));
+            sequence_cost(candidate, length + 1, last_operation, config, &span_ms, &completion_ms);
+            if (completion_ms < best_cost)
+            {
+                best_cost = completion_ms;
+                best = p;
+            }
+        }
+
+        memmove(order + best + 1, order + best, (length - best) * sizeof(Plane *));
+        memmove(shifted + best + 1, shifted + best, (length - best) * sizeof(int));
+        order[best] = planes[i];
+        shifted[best] = 0;
+        length++;
+        for (int p = best + 1; p < length; p++)
+            shifted[p]++;
+    }
+
+    sequence_cost(order, count, last_operation, config, &span_ms, &completion_ms);
+    estimate->plan_span_ms = span_ms;
+    estimate->plan_completion_ms = completion_ms;
+
+    int changed = memcmp(order, planes, count * sizeof(Plane *)) != 0;
+    memcpy(planes, order, count * sizeof(Plane *));
+    return changed;
+}
@@ -0,0 +1,25 @@
+#ifndef SEQUENCE_H
+#define SEQUENCE_H
+
+#include "plane.h"
+#include "runway.h"
+
+#define SEQUENCE_MAX_WINDOW 32
+#define SEQUENCE_DEFAULT_SHIFT 3
+
+// Cost of one window in arrival order and in the planned order, measured
+// from the moment the runway is free
+typedef struct
+{
+    long long fifo_span_ms;       // When the last plane of the window finishes
+    long long plan_span_ms;
+    long long fifo_completion_ms; // Sum of the planes' completion times
+    long long plan_completion_ms;
+} SequenceEstimate;
+
+// Sequencing functions
+long long sequence_occupancy_ms(const RunwayConfig *config, int leader, Plane *plane);
+int sequence_plan(Plane **planes, int count, int last_operation, const RunwayConfig *config,
+                  int max_shift, SequenceEstimate *estimate);
+
+#endif // SEQUENCE_H
@@ -0,0 +1,433 @@
+#include "sim.h"
+#include "runway.h"
+#include "bus.h"
+#include "pool.h"
+#include "workload.h"
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <stdatomic.h>
+
+int sim_virtual_mode = 0;
+
+static EventQueue sim_events;
+static long long sim_clock_ms = 0;
+static const SimDriver *sim_driver = NULL;
+static atomic_int sim_next_plane_id = 1; // Read by sim_finished() on every engine worker
+static Workload *sim_workload = NULL; // Generated traffic or a replayed trace
+static atomic_int sim_arrivals_done = 0; // No more planes will be created
+static long long sim_snapshot_at_ms = -1; // Simulated time of the pending snapshot
+static const char *sim_snapshot_path = NULL;
+
+// Order events by time, then by insertion sequence for deterministic ties
+static int event_before(const SimEvent *a, const SimEvent *b)
+{
+    if (a->time_ms != b->time_ms)
+        return a->time_ms < b->time_ms;
+    return a->seq < b->seq;
+}
+
+// Initialize event queue
+void event_queue_init(EventQueue *eq)
+{
+    eq->events = NULL;
+    eq->count = 0;
+    eq->capacity = 0;
+    eq->next_seq = 0;
+}
+
+// Insert an event (sift up)
+int event_queue_push(EventQueue *eq, long long time_ms, SimEventType type, Plane *plane)
+{
+    if (eq->count == eq->capacity)
+    {
+        int new_capacity = (eq->capacity == 0) ? 64 : eq->capacity * 2;
+        SimEvent *events = (SimEvent *)realloc(eq->events, new_capacity * sizeof(SimEvent));
+        if (events == NULL)
+        {
+            perror("Failed to grow event queue");
+            return -1;
+        }
+        eq->events = events;
+        eq->capacity = new_capacity;
+    }
+
+    SimEvent event = {time_ms, eq->next_seq++, type, plane};
+    int i = eq->count++;
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!event_before(&event, &eq->events[parent]))
+            break;
+        eq->events[i] = eq->events[parent];
+        i = parent;
+    }
+    eq->events[i] = event;
+    return 0;
+}
+
+// Remove the earliest event (sift down); returns 0 if queue is empty
+int event_queue_pop(EventQueue *eq, SimEvent *event)
+{
+    if (eq->count == 0)
+        return 0;
+
+    *event = eq->events[0];
+    SimEvent last = eq->events[--eq->count];
+    int i = 0;
+    while (1)
+    {
+        int child = 2 * i + 1;
+        if (child >= eq->count)
+            break;
+        if (child + 1 < eq->count && event_before(&eq->events[child + 1], &eq->events[child]))
+            child++;
+        if (!event_before(&eq->events[child], &last))
+            break;
+        eq->events[i] = eq->events[child];
+        i = child;
+    }
+    if (eq->count > 0)
+        eq->events[i] = last;
+    return 1;
+}
+
+// Destroy event queue
+void event_queue_destroy(EventQueue *eq)
+{
+    free(eq->events);
+    eq->events = NULL;
+    eq->count = 0;
+    eq->capacity = 0;
+}
+
+// Virtual clock: time of the event being processed
+static long long sim_virtual_now_ms()
+{
+    return sim_clock_ms;
+}
+
+static void sim_virtual_schedule(long long time_ms, SimEventType type, Plane *plane)
+{
+    event_queue_push(&sim_events, time_ms, type, plane);
+}
+
+static const SimDriver sim_virtual_driver = {sim_virtual_now_ms, sim_virtual_schedule};
+
+// Select the clock and scheduler used by the state machine
+void sim_set_driver(const SimDriver *driver)
+{
+    sim_driver = driver;
+}
+
+// Current time in milliseconds since simulation start (monotonic wall clock
+// when no driver is active, as in thread-per-plane mode; the virtual clock
+// stands at its start while a virtual run is being set up)
+long long sim_now_ms()
+{
+    if (sim_driver != NULL)
+        return sim_driver->now_ms();
+    if (sim_virtual_mode)
+        return sim_clock_ms;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000LL + now.tv_nsec / 1000000;
+}
+
+// Current time in nanoseconds for lifecycle timing: simulated time in
+// virtual mode, CLOCK_MONOTONIC otherwise (only differences are meaningful)
+long long sim_now_ns()
+{
+    if (sim_virtual_mode)
+        return sim_now_ms() * 1000000LL;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Source of arriving flights for the next sim_start()
+void sim_set_workload(Workload *workload)
+{
+    sim_workload = workload;
+}
+
+// Create the next plane and report its arrival time; NULL once traffic ends
+static Plane *sim_next_arrival(long long *arrival_ms)
+{
+    TraceFlight flight;
+    if (!workload_next(sim_workload, &flight))
+    {
+        sim_arrivals_done = 1;
+        return NULL;
+    }
+
+    Plane *plane = (Plane *)pool_alloc(&plane_pool);
+    if (plane == NULL)
+    {
+        perror("Failed to allocate plane");
+        sim_arrivals_done = 1;
+        return NULL;
+    }
+    trace_plane_init(plane, sim_next_plane_id++, &flight);
+    if (sim_workload->trace != NULL)
+        runway_system.total_planes = sim_next_plane_id - 1;
+    *arrival_ms = runway_system.start_ms + flight.arrival_ms;
+    return plane;
+}
+
+// Create the next plane and schedule it at its arrival time.
+// Only one arrival is pending at a time.
+static void sim_schedule_arrival()
+{
+    long long arrival_ms;
+    Plane *plane = sim_next_arrival(&arrival_ms);
+    if (plane != NULL)
+        sim_driver->schedule(arrival_ms, SIM_ARRIVAL, plane);
+}
+
+// Every plane that will ever arrive has completed
+int sim_finished()
+{
+    return sim_arrivals_done && stats_read(&runway_stats, STAT_PLANES_COMPLETED) >= sim_next_plane_id - 1;
+}
+
+// Milliseconds of runway time already spent by a plane
+static long long sim_elapsed_ms(Plane *plane)
+{
+    return (long long)runway_operation_duration(plane) * 1000 * plane->checkpoint_progress / 100;
+}
+
+// Length of the plane's next checkpoint interval
+static long long sim_next_step_ms(Plane *plane)
+{
+    long long remaining = (long long)runway_operation_duration(plane) * 1000 - sim_elapsed_ms(plane);
+    return (remaining < CHECKPOINT_INTERVAL_MS) ? remaining : CHECKPOINT_INTERVAL_MS;
+}
+
+// Start or resume the active plane's operation
+static void sim_start_operation(Plane *plane)
+{
+    plane->state = USING_RUNWAY;
+
+    int duration = runway_operation_duration(plane);
+    BUS_PUBLISH(BUS_STARTED, plane, plane->runway_id,
+                plane->checkpoint_progress > 0 ? duration - (duration * plane->checkpoint_progress) / 100 : duration);
+
+    sim_driver->schedule(sim_now_ms() + sim_next_step_ms(plane), SIM_CHECKPOINT, plane);
+}
+
+// Hand free runways to queued planes and raise preemption requests. The
+// granted planes belong to the caller once dispatch returns.
+static void sim_try_grant()
+{
+    Plane *granted[MAX_RUNWAYS];
+    sem_wait(&runway_system.sched_sem);
+    int n = runway_dispatch(&runway_system, granted, MAX_RUNWAYS);
+    sem_post(&runway_system.sched_sem);
+
+    for (int i = 0; i < n; i++)
+    {
+        Plane *plane = granted[i];
+        plane->state = APPROACHING;
+        BUS_PUBLISH(BUS_GRANTED, plane, plane->runway_id, 0);
+        sim_start_operation(plane);
+    }
+}
+
+// Plane arrives and joins its priority queue, together with every later
+// flight that is already due (same arrival time, or late on the engine clock).
+// The next arrival is scheduled only after this batch is queued, so an engine
+// worker cannot admit later flights ahead of it.
+static void sim_handle_arrival(Plane *plane)
+{
+    Plane *batch[SIM_ARRIVAL_BATCH];
+    int count = 0;
+    batch[count++] = plane;
+
+    long long arrival_ms;
+    Plane *next;
+    while ((next = sim_next_arrival(&arrival_ms)) != NULL)
+    {
+        if (arrival_ms > sim_now_ms() || count == SIM_ARRIVAL_BATCH)
+            break;
+        batch[count++] = next;
+    }
+
+    runway_admit_batch(&runway_system, batch, count);
+    if (next != NULL)
+        sim_driver->schedule(arrival_ms, SIM_ARRIVAL, next);
+    sim_try_grant();
+}
+
+// Active plane reaches a checkpoint: complete, preempt or continue
+static void sim_handle_checkpoint(Plane *plane)
+{
+    long long duration_ms = (long long)runway_operation_duration(plane) * 1000;
+    long long elapsed = sim_elapsed_ms(plane) + sim_next_step_ms(plane);
+    int runway_id = plane->runway_id;
+    int finished = elapsed >= duration_ms;
+
+    // Progress is read by the GUI, and the preemption signal raised by
+    // dispatch, under sched_sem. A preempted plane rejoins the waiting set in
+    // the same section (as in runway_perform_operation()) and its events go
+    // out before the lock is released: after that, another engine worker may
+    // grant it.
+    sem_wait(&runway_system.sched_sem);
+    plane->checkpoint_progress = (int)((elapsed * 100) / duration_ms);
+    BUS_PUBLISH(BUS_CHECKPOINT, plane, runway_id, 0);
+
+    // Only raised for normal planes
+    int preempt = !finished && runway_system.runways[runway_id].preempt_flag;
+    if (finished)
+    {
+        plane->checkpoint_progress = 100;
+        runway_vacate(&runway_system, plane);
+    }
+    else if (preempt)
+    {
+        plane->state = INTERRUPTED;
+        runway_vacate(&runway_system, plane);
+        BUS_PUBLISH(BUS_PREEMPTED, plane, runway_id, 0);
+
+        plane->state = WAITING;
+        runway_enqueue_waiting(&runway_system, plane);
+        BUS_PUBLISH(BUS_REQUEUED, plane, -1, 0);
+    }
+    sem_post(&runway_system.sched_sem);
+
+    if (finished)
+    {
+        BUS_PUBLISH(BUS_FINISHED, plane, runway_id, 0);
+        BUS_PUBLISH(BUS_RELEASED, plane, runway_id, 0);
+
+        plane->state = COMPLETED;
+        plane_record_lifecycle(plane);
+        BUS_PUBLISH(BUS_COMPLETED, plane, -1, plane->cold->completion_ns - plane->cold->arrival_ns);
+        stats_add(&runway_stats, STAT_PLANES_COMPLETED, 1);
+
+        plane_destroy(plane);
+        pool_free(&plane_pool, plane);
+        sim_try_grant();
+        return;
+    }
+
+    if (preempt)
+    {
+        stats_add(&runway_stats, STAT_REQUEUES, 1);
+        sim_try_grant();
+        return;
+    }
+
+    sim_driver->schedule(sim_now_ms() + sim_next_step_ms(plane), SIM_CHECKPOINT, plane);
+}
+
+// Reset traffic generation and schedule the first arrival on the current driver
+void sim_start()
+{
+    sim_next_plane_id = 1;
+    sim_arrivals_done = 0;
+    runway_system.start_ms = sim_now_ms();
+    sim_schedule_arrival();
+}
+
+// Advance the plane state machine for one due event
+void sim_handle_event(const SimEvent *event)
+{
+    switch (event->type)
+    {
+    case SIM_ARRIVAL:
+        sim_handle_arrival(event->plane);
+        break;
+    case SIM_CHECKPOINT:
+        sim_handle_checkpoint(event->plane);
+        break;
+    }
+}
+
+// Write a snapshot once the clock reaches at_ms (virtual-time mode)
+void sim_set_snapshot(long long at_ms, const char *path)
+{
+    sim_snapshot_at_ms = at_ms;
+    sim_snapshot_path = path;
+}
+
+// Virtual-clock state for snapshots
+void sim_get_state(SimState *state)
+{
+    state->clock_ms = sim_clock_ms;
+    state->next_plane_id = sim_next_plane_id;
+    state->arrivals_done = sim_arrivals_done;
+    state->events = &sim_events;
+    state->workload = sim_workload;
+}
+
+// Reset the virtual clock to a restored state; the caller then pushes the
+// pending events onto state->events and calls sim_resume()
+void sim_restore(SimState *state)
+{
+    event_queue_init(&sim_events);
+    sim_set_driver(&sim_virtual_driver);
+    sim_clock_ms = state->clock_ms;
+    sim_next_plane_id = state->next_plane_id;
+    sim_arrivals_done = state->arrivals_done;
+    state->events = &sim_events;
+    state->workload = sim_workload;
+}
+
+// Process events until none are left, taking the pending snapshot on the way
+static void sim_loop()
+{
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    long long start_clock_ms = sim_clock_ms;
+
+    long long events_processed = 0;
+    SimEvent event;
+    while (sim_events.count > 0)
+    {
+        // Snapshots are taken between events, when no transition is half done
+        if (sim_snapshot_path != NULL && sim_events.events[0].time_ms >= sim_snapshot_at_ms)
+        {
+            if (sim_clock_ms < sim_snapshot_at_ms)
+                sim_clock_ms = sim_snapshot_at_ms;
+            if (snapshot_write(sim_snapshot_path) != 0)
+                fprintf(stderr, "Warning: Failed to write snapshot %s\n", sim_snapshot_path);
+            sim_snapshot_path = NULL;
+        }
+
+        event_queue_pop(&sim_events, &event);
+        sim_clock_ms = event.time_ms;
+        events_processed++;
+
+        sim_handle_event(&event);
+    }
+    if (sim_snapshot_path != NULL)
+        fprintf(stderr, "Warning: Simulation ended before the snapshot time; no snapshot written\n");
+
+    event_queue_destroy(&sim_events);
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double wall_seconds = (wall_end.tv_sec - wall_start.tv_sec) +
+                          (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+    runway_print_status("[SYSTEM] Virtual simulation finished: %lld events, %lld simulated seconds in %.3fs wall time",
+                        events_processed, (sim_now_ms() - start_clock_ms) / 1000, wall_seconds);
+}
+
+// Run the whole simulation on the virtual clock, as fast as events can be processed
+void sim_run()
+{
+    event_queue_init(&sim_events);
+    sim_clock_ms = 0;
+    sim_set_driver(&sim_virtual_driver);
+    sim_start();
+    sim_loop();
+}
+
+// Continue a simulation restored by sim_restore()
+void sim_resume()
+{
+    sim_loop();
+}
@@ -0,0 +1,78 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "plane.h"
+#include "workload.h"
+
+#define SIM_ARRIVAL_BATCH 512 // Most planes admitted by one arrival event
+
+// Simulation event types
+typedef enum
+{
+    SIM_ARRIVAL,   // Plane arrives and joins a queue
+    SIM_CHECKPOINT // Active plane reaches its next checkpoint
+} SimEventType;
+
+// Pending simulation event (ordered by time, ties broken by insertion order)
+typedef struct
+{
+    long long time_ms;
+    unsigned long seq;
+    SimEventType type;
+    Plane *plane;
+} SimEvent;
+
+// Binary min-heap of pending events
+typedef struct
+{
+    SimEvent *events;
+    int count;
+    int capacity;
+    unsigned long next_seq;
+} EventQueue;
+
+// Clock and event scheduler that drive the plane state machines
+typedef struct
+{
+    long long (*now_ms)(void);
+    void (*schedule)(long long time_ms, SimEventType type, Plane *plane);
+} SimDriver;
+
+// Virtual-clock state captured by snapshots
+typedef struct
+{
+    long long clock_ms;
+    int next_plane_id;
+    int arrivals_done;
+    EventQueue *events; // Pending arrivals and checkpoints
+    Workload *workload;
+} SimState;
+
+// Set when the simulation runs on the virtual clock (-V)
+extern int sim_virtual_mode;
+
+// Event queue operations
+void event_queue_init(EventQueue *eq);
+int event_queue_push(EventQueue *eq, long long time_ms, SimEventType type, Plane *plane);
+int event_queue_pop(EventQueue *eq, SimEvent *event);
+void event_queue_destroy(EventQueue *eq);
+
+// Plane state machine, shared by the virtual clock and the worker engine
+void sim_set_driver(const SimDriver *driver);
+void sim_set_workload(Workload *workload);
+void sim_start();
+int sim_finished();
+void sim_handle_event(const SimEvent *event);
+long long sim_now_ms();
+long long sim_now_ns();
+
+// Virtual-time simulation
+void sim_run();
+
+// Snapshot support (virtual-time mode)
+void sim_set_snapshot(long long at_ms, const char *path);
+void sim_get_state(SimState *state);
+void sim_restore(SimState *state);
+void sim_resume();
+
+#endif // SIM_H
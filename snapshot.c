@@ -0,0 +1,527 @@
+#define _DEFAULT_SOURCE // mmap, madvise
+
+#include "snapshot.h"
+#include "sim.h"
+#include "pool.h"
+#include "policy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Live planes collected from the plane pool, sorted by address for lookup
+typedef struct
+{
+    Plane **planes;
+    int count;
+    int capacity;
+} SnapshotPlanes;
+
+static void snapshot_collect_slab(void *objects, int count, void *arg)
+{
+    SnapshotPlanes *live = (SnapshotPlanes *)arg;
+    Plane *planes = (Plane *)objects;
+    for (int i = 0; i < count; i++)
+    {
+        if (planes[i].cold == NULL)
+            continue;
+        if (live->count == live->capacity)
+        {
+            int capacity = (live->capacity == 0) ? 256 : live->capacity * 2;
+            Plane **grown = (Plane **)realloc(live->planes, capacity * sizeof(Plane *));
+            if (grown == NULL)
+                return;
+            live->planes = grown;
+            live->capacity = capacity;
+        }
+        live->planes[live->count++] = &planes[i];
+    }
+}
+
+static int snapshot_compare_planes(const void *a, const void *b)
+{
+    const Plane *x = *(Plane *const *)a;
+    const Plane *y = *(Plane *const *)b;
+    return (x > y) - (x < y);
+}
+
+// Index of a plane in the sorted live set (-1 if unknown)
+static int snapshot_plane_index(const SnapshotPlanes *live, Plane *plane)
+{
+    if (plane == NULL)
+        return -1;
+    Plane **found = (Plane **)bsearch(&plane, live->planes, live->count, sizeof(Plane *),
+                                      snapshot_compare_planes);
+    return (found != NULL) ? (int)(found - live->planes) : -1;
+}
+
+static int snapshot_compare_events(const void *a, const void *b)
+{
+    const SimEvent *x = (const SimEvent *)a;
+    const SimEvent *y = (const SimEvent *)b;
+    if (x->time_ms != y->time_ms)
+        return (x->time_ms > y->time_ms) - (x->time_ms < y->time_ms);
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static int snapshot_compare_heap(const void *a, const void *b)
+{
+    const PQEntry *x = (const PQEntry *)a;
+    const PQEntry *y = (const PQEntry *)b;
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static void snapshot_fill_header(SnapshotHeader *header, const SimState *state, Workload *workload)
+{
+    RunwaySystem *sys = &runway_system;
+
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header->version = SNAPSHOT_VERSION;
+    header->runway_count = sys->runway_count;
+    header->use_priority_heap = sys->use_priority_heap;
+    header->aging_ms = sys->waiting_heap.aging_ms;
+    header->clock_ms = state->clock_ms;
+    header->start_ms = sys->start_ms;
+    header->landing_duration = sys->config.landing_duration;
+    header->takeoff_duration = sys->config.takeoff_duration;
+    header->next_plane_id = state->next_plane_id;
+    header->arrivals_done = state->arrivals_done;
+    header->total_planes = sys->total_planes;
+    memcpy(header->separation, sys->config.separation, sizeof(header->separation));
+    header->sequence_window = sys->sequence_window;
+    header->sequence_shift = sys->sequence_shift;
+    strncpy(header->policy, sys->policy->name, sizeof(header->policy) - 1);
+
+    SnapshotWorkload *w = &header->workload;
+    w->pattern = workload->pattern;
+    w->total_planes = workload->total_planes;
+    w->emergency_prob = workload->emergency_prob;
+    w->landing_pct = workload->landing_pct;
+    w->seed = workload->seed;
+    w->gap_rng = workload->gap_rng;
+    w->operation_rng = workload->operation_rng;
+    w->priority_rng = workload->priority_rng;
+    w->clock_ms = workload->clock_ms;
+    w->generated = workload->generated;
+    w->batch_remaining = workload->batch_count - workload->batch_pos;
+
+    for (int c = 0; c < STAT_COUNT; c++)
+        header->counters[c] = stats_read(&runway_stats, c);
+    for (int e = 0; e < 2; e++)
+    {
+        for (int b = 0; b < STATS_WAIT_BUCKETS; b++)
+            header->wait_buckets[e][b] = atomic_load(&runway_stats.wait_buckets[e][b]);
+    }
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++)
+    {
+        header->class_planes[c] = atomic_load(&runway_stats.class_planes[c]);
+        header->class_preemptions[c] = atomic_load(&runway_stats.class_preemptions[c]);
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            header->phase_sum_ns[c][p] = atomic_load(&runway_stats.phase_sum_ns[c][p]);
+            header->phase_max_ns[c][p] = atomic_load(&runway_stats.phase_max_ns[c][p]);
+        }
+    }
+}
+
+static void snapshot_fill_plane(SnapshotPlane *record, const Plane *plane)
+{
+    memset(record, 0, sizeof(*record));
+    record->id = plane->id;
+    record->runway_id = plane->runway_id;
+    record->duration = plane->duration;
+    record->checkpoint_progress = plane->checkpoint_progress;
+    record->state = plane->state;
+    record->operation = plane->operation;
+    record->priority = plane->priority;
+    record->priority_class = plane->priority_class;
+    record->preemptions = plane->cold->preemptions;
+    record->separation = plane->cold->separation;
+    record->overtaken = plane->cold->overtaken;
+    record->arrival_ns = plane->cold->arrival_ns;
+    record->first_grant_ns = plane->cold->first_grant_ns;
+    record->granted_ns = plane->cold->granted_ns;
+    record->preempted_ns = plane->cold->preempted_ns;
+    record->completion_ns = plane->cold->completion_ns;
+    record->service_ns = plane->cold->service_ns;
+    record->preempt_overhead_ns = plane->cold->preempt_overhead_ns;
+    record->queued_seq = (int64_t)plane->cold->queued_seq;
+}
+
+// Write the queues, runways, live planes, counters and pending arrival stream.
+// Called by the virtual-time loop between events.
+int snapshot_write(const char *path)
+{
+    RunwaySystem *sys = &runway_system;
+    SimState state;
+    sim_get_state(&state);
+    if (state.workload == NULL || state.workload->trace != NULL)
+    {
+        fprintf(stderr, "Error: Snapshots need generated traffic (not a replayed trace)\n");
+        return -1;
+    }
+
+    SnapshotPlanes live = {NULL, 0, 0};
+    pool_sweep(&plane_pool, snapshot_collect_slab, &live);
+    qsort(live.planes, live.count, sizeof(Plane *), snapshot_compare_planes);
+
+    SnapshotHeader header;
+    snapshot_fill_header(&header, &state, state.workload);
+    header.plane_count = live.count;
+    header.event_count = state.events->count;
+
+    // FIFO queues in service order
+    int max_waiting = live.count > 0 ? live.count : 1;
+    Plane **waiting = (Plane **)malloc(max_waiting * sizeof(Plane *));
+    int32_t *queue_indices = (int32_t *)malloc(max_waiting * sizeof(int32_t));
+    if (waiting == NULL || queue_indices == NULL)
+    {
+        perror("Failed to allocate snapshot buffers");
+        free(live.planes);
+        free(waiting);
+        free(queue_indices);
+        return -1;
+    }
+    if (!sys->use_priority_heap)
+    {
+        header.emergency_count = queue_snapshot(&sys->emergency_queue, waiting, max_waiting);
+        for (int i = 0; i < header.emergency_count; i++)
+            queue_indices[i] = snapshot_plane_index(&live, waiting[i]);
+        header.normal_count = queue_snapshot(&sys->normal_queue, waiting, max_waiting - header.emergency_count);
+        for (int i = 0; i < header.normal_count; i++)
+            queue_indices[header.emergency_count + i] = snapshot_plane_index(&live, waiting[i]);
+    }
+    else
+    {
+        header.heap_count = sys->waiting_heap.count;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        perror("Failed to create snapshot");
+        free(live.planes);
+        free(waiting);
+        free(queue_indices);
+        return -1;
+    }
+    fwrite(&header, sizeof(header), 1, file);
+
+    for (int i = 0; i < live.count; i++)
+    {
+        SnapshotPlane record;
+        snapshot_fill_plane(&record, live.planes[i]);
+        fwrite(&record, sizeof(record), 1, file);
+    }
+
+    // Events in (time, seq) order, so pushing them back keeps tie order
+    SimEvent *events = (SimEvent *)malloc((state.events->count + 1) * sizeof(SimEvent));
+    if (events != NULL)
+    {
+        memcpy(events, state.events->events, state.events->count * sizeof(SimEvent));
+        qsort(events, state.events->count, sizeof(SimEvent), snapshot_compare_events);
+        for (int i = 0; i < state.events->count; i++)
+        {
+            SnapshotEvent record = {events[i].time_ms, events[i].type,
+                                    snapshot_plane_index(&live, events[i].plane)};
+            fwrite(&record, sizeof(record), 1, file);
+        }
+        free(events);
+    }
+
+    for (int i = 0; i < sys->runway_count; i++)
+    {
+        Runway *runway = &sys->runways[i];
+        SnapshotRunway record;
+        memset(&record, 0, sizeof(record));
+        record.role = runway->role;
+        record.active_plane = snapshot_plane_index(&live, runway->active_plane);
+        record.preempt_flag = runway->preempt_flag;
+        record.operations_completed = runway->operations_completed;
+        record.preemptions = runway->preemptions;
+        record.last_operation = runway->last_operation;
+        record.preempt_requested_ns = runway->preempt_requested_ns;
+        record.busy_since_ms = runway->busy_since_ms;
+        record.busy_ms = runway->busy_ms;
+        fwrite(&record, sizeof(record), 1, file);
+    }
+
+    // Heap entries in arrival order, so reinserting keeps FIFO tie-breaks
+    if (header.heap_count > 0)
+    {
+        PQEntry *entries = (PQEntry *)malloc(header.heap_count * sizeof(PQEntry));
+        if (entries != NULL)
+        {
+            memcpy(entries, sys->waiting_heap.entries, header.heap_count * sizeof(PQEntry));
+            qsort(entries, header.heap_count, sizeof(PQEntry), snapshot_compare_heap);
+            for (int i = 0; i < header.heap_count; i++)
+            {
+                SnapshotHeapEntry record = {entries[i].enqueue_ms, snapshot_plane_index(&live, entries[i].plane), 0};
+                fwrite(&record, sizeof(record), 1, file);
+            }
+            free(entries);
+        }
+    }
+
+    Workload *workload = state.workload;
+    fwrite(&workload->batch[workload->batch_pos], sizeof(TraceFlight), header.workload.batch_remaining, file);
+    fwrite(queue_indices, sizeof(int32_t), header.emergency_count + header.normal_count, file);
+
+    int failed = ferror(file);
+    if (fclose(file) != 0)
+        failed = 1;
+
+    runway_print_status("[SNAPSHOT] Wrote %s: %d planes, %d pending events at %lld simulated seconds",
+                        path, live.count, header.event_count, header.clock_ms / 1000);
+
+    free(live.planes);
+    free(waiting);
+    free(queue_indices);
+    return failed ? -1 : 0;
+}
+
+// Rebuild one plane from its record
+static Plane *snapshot_restore_plane(const SnapshotPlane *record)
+{
+    Plane *plane = (Plane *)pool_alloc(&plane_pool);
+    if (plane == NULL)
+        return NULL;
+
+    plane_init(plane, record->id, record->operation, record->priority);
+    plane->runway_id = record->runway_id;
+    plane->duration = record->duration;
+    plane->checkpoint_progress = record->checkpoint_progress;
+    plane->state = record->state;
+    plane->priority_class = record->priority_class;
+
+    PlaneCold *cold = plane->cold;
+    cold->preemptions = record->preemptions;
+    cold->separation = record->separation;
+    cold->overtaken = record->overtaken;
+    cold->arrival_ns = record->arrival_ns;
+    cold->first_grant_ns = record->first_grant_ns;
+    cold->granted_ns = record->granted_ns;
+    cold->preempted_ns = record->preempted_ns;
+    cold->completion_ns = record->completion_ns;
+    cold->service_ns = record->service_ns;
+    cold->preempt_overhead_ns = record->preempt_overhead_ns;
+    cold->queued_seq = (unsigned long)record->queued_seq;
+    return plane;
+}
+
+static void snapshot_restore_stats(const SnapshotHeader *header)
+{
+    stats_init(&runway_stats);
+    for (int c = 0; c < STAT_COUNT; c++)
+    {
+        if (c == STAT_PREEMPT_LATENCY_MAX_NS)
+            stats_max(&runway_stats, c, header->counters[c]);
+        else
+            stats_add(&runway_stats, c, header->counters[c]);
+    }
+    for (int e = 0; e < 2; e++)
+    {
+        for (int b = 0; b < STATS_WAIT_BUCKETS; b++)
+            atomic_store(&runway_stats.wait_buckets[e][b], header->wait_buckets[e][b]);
+    }
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++)
+    {
+        atomic_store(&runway_stats.class_planes[c], header->class_planes[c]);
+        atomic_store(&runway_stats.class_preemptions[c], header->class_preemptions[c]);
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            atomic_store(&runway_stats.phase_sum_ns[c][p], header->phase_sum_ns[c][p]);
+            atomic_store(&runway_stats.phase_max_ns[c][p], header->phase_max_ns[c][p]);
+        }
+    }
+}
+
+static void snapshot_restore_workload(Workload *workload, const SnapshotWorkload *w, const TraceFlight *batch)
+{
+    workload_init(workload, (WorkloadPattern)w->pattern, w->total_planes, w->emergency_prob,
+                  w->landing_pct, w->seed);
+    workload->gap_rng = w->gap_rng;
+    workload->operation_rng = w->operation_rng;
+    workload->priority_rng = w->priority_rng;
+    workload->clock_ms = w->clock_ms;
+    workload->generated = w->generated;
+    memcpy(workload->batch, batch, w->batch_remaining * sizeof(TraceFlight));
+    workload->batch_count = w->batch_remaining;
+    workload->batch_pos = 0;
+}
+
+// Map a snapshot and rebuild the runway system, statistics, workload and
+// virtual clock from it. Pools must be initialized; call sim_resume() next.
+int snapshot_restore(const char *path, Workload *workload)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror("Failed to open snapshot");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader))
+    {
+        fprintf(stderr, "Error: %s is not a snapshot\n", path);
+        close(fd);
+        return -1;
+    }
+    size_t size = st.st_size;
+    const char *data = (const char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror("Failed to map snapshot");
+        return -1;
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    const SnapshotHeader *header = (const SnapshotHeader *)data;
+    const SnapshotPlane *plane_records = (const SnapshotPlane *)(header + 1);
+    const SnapshotEvent *event_records = (const SnapshotEvent *)(plane_records + header->plane_count);
+    const SnapshotRunway *runway_records = (const SnapshotRunway *)(event_records + header->event_count);
+    const SnapshotHeapEntry *heap_records = (const SnapshotHeapEntry *)(runway_records + header->runway_count);
+    const TraceFlight *batch = (const TraceFlight *)(heap_records + header->heap_count);
+    const int32_t *queue_indices = (const int32_t *)(batch + header->workload.batch_remaining);
+    const char *end = (const char *)(queue_indices + header->emergency_count + header->normal_count);
+
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->version != SNAPSHOT_VERSION || header->plane_count < 0 || header->event_count < 0 ||
+        header->runway_count < 1 || header->runway_count > MAX_RUNWAYS || header->heap_count < 0 ||
+        header->workload.batch_remaining < 0 || header->workload.batch_remaining > WORKLOAD_BATCH ||
+        end > data + size)
+    {
+        fprintf(stderr, "Error: %s is not a valid snapshot (version %d expected)\n", path, SNAPSHOT_VERSION);
+        munmap((void *)data, size);
+        return -1;
+    }
+
+    // Runway table and configuration
+    RunwaySystem *sys = &runway_system;
+    char roles[MAX_RUNWAYS + 1];
+    for (int i = 0; i < header->runway_count; i++)
+    {
+        RunwayRole role = (RunwayRole)runway_records[i].role;
+        roles[i] = (role == RUNWAY_LANDING_ONLY) ? 'L' : (role == RUNWAY_TAKEOFF_ONLY) ? 'T' : 'M';
+    }
+    roles[header->runway_count] = '\0';
+
+    char policy_name[sizeof(header->policy) + 1];
+    memcpy(policy_name, header->policy, sizeof(header->policy));
+    policy_name[sizeof(header->policy)] = '\0';
+    const SchedPolicy *policy = policy_find(policy_name);
+    if (policy == NULL)
+    {
+        fprintf(stderr, "Error: %s uses the %s scheduling policy, which this build does not offer (%s)\n",
+                path, policy_name, policy_names());
+        munmap((void *)data, size);
+        return -1;
+    }
+
+    runway_init(sys, header->landing_duration, header->takeoff_duration);
+    runway_configure(sys, header->runway_count, roles);
+    if (policy == &policy_aging)
+        runway_enable_priority_heap(sys, header->aging_ms);
+    else
+        runway_set_policy(sys, policy);
+    sys->start_ms = header->start_ms;
+    sys->total_planes = header->total_planes;
+    memcpy(sys->config.separation, header->separation, sizeof(sys->config.separation));
+    runway_enable_sequencing(sys, header->sequence_window, header->sequence_shift);
+    snapshot_restore_stats(header);
+    snapshot_restore_workload(workload, &header->workload, batch);
+
+    SimState state = {header->clock_ms, header->next_plane_id, header->arrivals_done, NULL, NULL};
+    sim_set_workload(workload);
+    sim_restore(&state);
+
+    // Planes
+    Plane **planes = (Plane **)malloc((header->plane_count + 1) * sizeof(Plane *));
+    if (planes == NULL)
+    {
+        perror("Failed to allocate snapshot planes");
+        munmap((void *)data, size);
+        return -1;
+    }
+    unsigned long queued_seq = 0;
+    for (int i = 0; i < header->plane_count; i++)
+    {
+        planes[i] = snapshot_restore_plane(&plane_records[i]);
+        if (planes[i] == NULL)
+        {
+            perror("Failed to allocate plane");
+            free(planes);
+            munmap((void *)data, size);
+            return -1;
+        }
+        if (planes[i]->cold->queued_seq >= queued_seq)
+            queued_seq = planes[i]->cold->queued_seq + 1;
+    }
+    // Planes joining the queues from here on line up behind the restored ones
+    atomic_store(&sys->queued_seq, queued_seq);
+
+    int invalid = 0;
+    for (int i = 0; i < header->runway_count; i++)
+    {
+        const SnapshotRunway *record = &runway_records[i];
+        Runway *runway = &sys->runways[i];
+        int active = record->active_plane;
+        invalid |= (active >= header->plane_count);
+        runway->active_plane = (active >= 0 && active < header->plane_count) ? planes[active] : NULL;
+        atomic_store(&runway->active_plane_id, runway->active_plane != NULL ? runway->active_plane->id : -1);
+        runway->preempt_flag = record->preempt_flag;
+        runway->operations_completed = record->operations_completed;
+        runway->preemptions = record->preemptions;
+        runway->last_operation = record->last_operation;
+        runway->preempt_requested_ns = record->preempt_requested_ns;
+        runway->busy_since_ms = record->busy_since_ms;
+        runway->busy_ms = record->busy_ms;
+    }
+
+    // Waiting planes, in their original service order
+    for (int i = 0; i < header->heap_count; i++)
+    {
+        int index = heap_records[i].plane;
+        if (index < 0 || index >= header->plane_count)
+        {
+            invalid = 1;
+            continue;
+        }
+        pqueue_insert(&sys->waiting_heap, planes[index], heap_records[i].enqueue_ms);
+    }
+    for (int i = 0; i < header->emergency_count + header->normal_count; i++)
+    {
+        int index = queue_indices[i];
+        if (index < 0 || index >= header->plane_count)
+        {
+            invalid = 1;
+            continue;
+        }
+        queue_enqueue(i < header->emergency_count ? &sys->emergency_queue : &sys->normal_queue, planes[index]);
+    }
+
+    for (int i = 0; i < header->event_count; i++)
+    {
+        int index = event_records[i].plane;
+        if (index < 0 || index >= header->plane_count)
+        {
+            invalid = 1;
+            continue;
+        }
+        event_queue_push(state.events, event_records[i].time_ms, (SimEventType)event_records[i].type, planes[index]);
+    }
+
+    if (invalid)
+        fprintf(stderr, "Warning: %s references unknown planes; some were skipped\n", path);
+    runway_print_status("[SNAPSHOT] Restored %s: %d planes, %d pending events at %lld simulated seconds",
+                        path, header->plane_count, header->event_count, header->clock_ms / 1000);
+
+    free(planes);
+    munmap((void *)data, size);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include "stats.h"
+#include "workload.h"
+#include "runway.h"
+
+#define SNAPSHOT_MAGIC "RWYSNAP"
+#define SNAPSHOT_VERSION 5
+
+// File layout: SnapshotHeader, then plane_count SnapshotPlanes, event_count
+// SnapshotEvents, runway_count SnapshotRunways, heap_count SnapshotHeapEntries,
+// batch_remaining TraceFlights, and finally the FIFO queues as plane indices
+// (emergency first). Every record is a multiple of 8 bytes so the mapped file
+// can be read in place.
+
+// Generated traffic still to come
+typedef struct
+{
+    int32_t pattern;
+    int32_t total_planes;
+    int32_t emergency_prob;
+    int32_t landing_pct;
+    uint64_t seed;
+    Rng gap_rng;
+    Rng operation_rng;
+    Rng priority_rng;
+    int64_t clock_ms;
+    int32_t generated;
+    int32_t batch_remaining; // Pre-generated flights not handed out yet
+} SnapshotWorkload;
+
+typedef struct
+{
+    char magic[8];
+    int32_t version;
+    int32_t plane_count;
+    int32_t event_count;
+    int32_t runway_count;
+    int32_t emergency_count;
+    int32_t normal_count;
+    int32_t heap_count;
+    int32_t use_priority_heap;
+    int64_t aging_ms;
+    int64_t clock_ms;
+    int64_t start_ms;
+    int32_t landing_duration;
+    int32_t takeoff_duration;
+    int32_t next_plane_id;
+    int32_t arrivals_done;
+    int32_t total_planes;
+    int32_t reserved;
+    int32_t separation[2][2];
+    int32_t sequence_window;
+    int32_t sequence_shift;
+    char policy[16];           // Scheduling policy name (policy.h)
+    SnapshotWorkload workload;
+    int64_t counters[STAT_COUNT];
+    int64_t wait_buckets[2][STATS_WAIT_BUCKETS];
+    int64_t class_planes[PRIORITY_CLASS_COUNT];
+    int64_t class_preemptions[PRIORITY_CLASS_COUNT];
+    int64_t phase_sum_ns[PRIORITY_CLASS_COUNT][PHASE_COUNT];
+    int64_t phase_max_ns[PRIORITY_CLASS_COUNT][PHASE_COUNT];
+} SnapshotHeader;
+
+// A live plane: waiting, on a runway, or created for the pending arrival
+typedef struct
+{
+    int32_t id;
+    int32_t runway_id;
+    int32_t duration;
+    int32_t checkpoint_progress;
+    uint8_t state;
+    uint8_t operation;
+    uint8_t priority;
+    uint8_t priority_class;
+    int32_t preemptions;
+    int32_t separation;
+    int32_t overtaken;
+    int64_t arrival_ns;
+    int64_t first_grant_ns;
+    int64_t granted_ns;
+    int64_t preempted_ns;
+    int64_t completion_ns;
+    int64_t service_ns;
+    int64_t preempt_overhead_ns;
+    int64_t queued_seq;
+} SnapshotPlane;
+
+typedef struct
+{
+    int64_t time_ms;
+    int32_t type;
+    int32_t plane; // Index into the plane records
+} SnapshotEvent;
+
+typedef struct
+{
+    int32_t role;
+    int32_t active_plane; // Plane index, -1 when free
+    int32_t preempt_flag;
+    int32_t operations_completed;
+    int32_t preemptions;
+    int32_t last_operation;
+    int64_t preempt_requested_ns;
+    int64_t busy_since_ms;
+    int64_t busy_ms;
+} SnapshotRunway;
+
+typedef struct
+{
+    int64_t enqueue_ms;
+    int32_t plane;
+    int32_t reserved;
+} SnapshotHeapEntry;
+
+// Snapshot functions (virtual-time mode)
+int snapshot_write(const char *path);
+int snapshot_restore(const char *path, Workload *workload);
+
+#endif // SNAPSHOT_H
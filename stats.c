@@ -0,0 +1,196 @@
+#include "stats.h"
+#include <math.h>
+
+// Global statistics instance
+Stats runway_stats;
+
+// Shard used by the calling thread (-1 until its first update)
+static _Thread_local int stats_shard = -1;
+
+// Reset every counter
+void stats_init(Stats *stats)
+{
+    for (int s = 0; s < STATS_SHARDS; s++)
+    {
+        for (int c = 0; c < STAT_COUNT; c++)
+            atomic_init(&stats->shards[s].counters[c], 0);
+    }
+    atomic_init(&stats->next_shard, 0);
+    for (int e = 0; e < 2; e++)
+    {
+        for (int b = 0; b < STATS_WAIT_BUCKETS; b++)
+            atomic_init(&stats->wait_buckets[e][b], 0);
+        atomic_init(&stats->wait_max_ms[e], 0);
+    }
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++)
+    {
+        atomic_init(&stats->class_planes[c], 0);
+        atomic_init(&stats->class_preemptions[c], 0);
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            atomic_init(&stats->phase_sum_ns[c][p], 0);
+            atomic_init(&stats->phase_max_ns[c][p], 0);
+        }
+    }
+}
+
+// Shard for the calling thread, assigned on first use
+static StatShard *stats_local_shard(Stats *stats)
+{
+    if (stats_shard < 0)
+        stats_shard = atomic_fetch_add_explicit(&stats->next_shard, 1, memory_order_relaxed) % STATS_SHARDS;
+    return &stats->shards[stats_shard];
+}
+
+// Add value to a summed counter
+void stats_add(Stats *stats, StatCounter counter, long value)
+{
+    atomic_fetch_add_explicit(&stats_local_shard(stats)->counters[counter], value, memory_order_relaxed);
+}
+
+// Raise a maximum counter to value if it is larger
+void stats_max(Stats *stats, StatCounter counter, long value)
+{
+    atomic_long *slot = &stats_local_shard(stats)->counters[counter];
+    long current = atomic_load_explicit(slot, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(slot, &current, value,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+// Merge a counter across shards (sum, or max for STAT_PREEMPT_LATENCY_MAX_NS)
+long stats_read(Stats *stats, StatCounter counter)
+{
+    long total = 0;
+    for (int s = 0; s < STATS_SHARDS; s++)
+    {
+        long value = atomic_load_explicit(&stats->shards[s].counters[counter], memory_order_relaxed);
+        if (counter == STAT_PREEMPT_LATENCY_MAX_NS)
+            total = (value > total) ? value : total;
+        else
+            total += value;
+    }
+    return total;
+}
+
+// Histogram bucket for a wait: exact below 16 ms, then 16 buckets per power of two
+static int stats_wait_bucket(long long wait_ms)
+{
+    if (wait_ms < STATS_WAIT_SUB_BUCKETS)
+        return (wait_ms < 0) ? 0 : (int)wait_ms;
+
+    int exponent = 63 - __builtin_clzll((unsigned long long)wait_ms);
+    int mantissa = (int)(wait_ms >> (exponent - 4)) & (STATS_WAIT_SUB_BUCKETS - 1);
+    int bucket = STATS_WAIT_SUB_BUCKETS + (exponent - 4) * STATS_WAIT_SUB_BUCKETS + mantissa;
+    return (bucket < STATS_WAIT_BUCKETS) ? bucket : STATS_WAIT_BUCKETS - 1;
+}
+
+// Smallest wait that falls into a bucket
+static long long stats_bucket_floor(int bucket)
+{
+    if (bucket < STATS_WAIT_SUB_BUCKETS)
+        return bucket;
+
+    int exponent = (bucket - STATS_WAIT_SUB_BUCKETS) / STATS_WAIT_SUB_BUCKETS + 4;
+    int mantissa = (bucket - STATS_WAIT_SUB_BUCKETS) % STATS_WAIT_SUB_BUCKETS;
+    return (long long)(STATS_WAIT_SUB_BUCKETS + mantissa) << (exponent - 4);
+}
+
+// Record how long a plane queued before its first grant
+void stats_record_wait(Stats *stats, int emergency, long long wait_ms)
+{
+    stats_add(stats, emergency ? STAT_WAITS_EMERGENCY : STAT_WAITS_NORMAL, 1);
+    stats_add(stats, emergency ? STAT_WAIT_EMERGENCY_MS : STAT_WAIT_NORMAL_MS, wait_ms);
+    atomic_fetch_add_explicit(&stats->wait_buckets[emergency != 0][stats_wait_bucket(wait_ms)], 1,
+                              memory_order_relaxed);
+
+    atomic_long *max = &stats->wait_max_ms[emergency != 0];
+    long current = atomic_load_explicit(max, memory_order_relaxed);
+    while (wait_ms > current &&
+           !atomic_compare_exchange_weak_explicit(max, &current, wait_ms,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+// Mean wait before the first grant (0 when nothing was granted)
+double stats_wait_mean_ms(Stats *stats, int emergency)
+{
+    long count = stats_read(stats, emergency ? STAT_WAITS_EMERGENCY : STAT_WAITS_NORMAL);
+    long total = stats_read(stats, emergency ? STAT_WAIT_EMERGENCY_MS : STAT_WAIT_NORMAL_MS);
+    return count > 0 ? (double)total / count : 0.0;
+}
+
+// Wait at the given percentile (0-100) by nearest rank, reported as the
+// bucket midpoint but never above the longest recorded wait (the midpoint is
+// always below the top of its bucket)
+long long stats_wait_percentile_ms(Stats *stats, int emergency, double percentile)
+{
+    atomic_long *buckets = stats->wait_buckets[emergency != 0];
+    long count = 0;
+    for (int b = 0; b < STATS_WAIT_BUCKETS; b++)
+        count += atomic_load_explicit(&buckets[b], memory_order_relaxed);
+    if (count == 0)
+        return 0;
+
+    long rank = (long)ceil(percentile / 100.0 * count) - 1;
+    if (rank < 0)
+        rank = 0;
+    if (rank > count - 1)
+        rank = count - 1;
+    long long max = atomic_load_explicit(&stats->wait_max_ms[emergency != 0], memory_order_relaxed);
+    long seen = 0;
+    for (int b = 0; b < STATS_WAIT_BUCKETS; b++)
+    {
+        seen += atomic_load_explicit(&buckets[b], memory_order_relaxed);
+        if (seen > rank)
+        {
+            long long midpoint = (stats_bucket_floor(b) + stats_bucket_floor(b + 1)) / 2;
+            return (midpoint < max) ? midpoint : max;
+        }
+    }
+    return max;
+}
+
+// Add one completed plane's phase durations to its class
+void stats_record_lifecycle(Stats *stats, int priority_class, const long long phase_ns[PHASE_COUNT], int preemptions)
+{
+    if (priority_class < 0 || priority_class >= PRIORITY_CLASS_COUNT)
+        return;
+
+    atomic_fetch_add_explicit(&stats->class_planes[priority_class], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->class_preemptions[priority_class], preemptions, memory_order_relaxed);
+    for (int p = 0; p < PHASE_COUNT; p++)
+    {
+        atomic_fetch_add_explicit(&stats->phase_sum_ns[priority_class][p], phase_ns[p], memory_order_relaxed);
+
+        atomic_long *slot = &stats->phase_max_ns[priority_class][p];
+        long current = atomic_load_explicit(slot, memory_order_relaxed);
+        while (phase_ns[p] > current &&
+               !atomic_compare_exchange_weak_explicit(slot, &current, phase_ns[p],
+                                                      memory_order_relaxed, memory_order_relaxed))
+            ;
+    }
+}
+
+long stats_class_planes(Stats *stats, int priority_class)
+{
+    return atomic_load(&stats->class_planes[priority_class]);
+}
+
+long stats_class_preemptions(Stats *stats, int priority_class)
+{
+    return atomic_load(&stats->class_preemptions[priority_class]);
+}
+
+// Mean phase duration per completed plane of the class
+double stats_phase_mean_ns(Stats *stats, int priority_class, LifecyclePhase phase)
+{
+    long planes = stats_class_planes(stats, priority_class);
+    return planes > 0 ? (double)atomic_load(&stats->phase_sum_ns[priority_class][phase]) / planes : 0.0;
+}
+
+long stats_phase_max_ns(Stats *stats, int priority_class, LifecyclePhase phase)
+{
+    return atomic_load(&stats->phase_max_ns[priority_class][phase]);
+}
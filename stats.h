@@ -0,0 +1,86 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdatomic.h>
+#include "plane.h"
+
+#define STATS_SHARDS 16 // Threads are spread round-robin over this many shards
+#define STATS_WAIT_SUB_BUCKETS 16 // Histogram buckets per power of two (about 6% resolution)
+#define STATS_WAIT_BUCKETS 640    // Covers waits up to 2^40 ms
+
+// Simulation counters; every update is one relaxed atomic add on the
+// calling thread's shard, and reads merge all shards
+typedef enum
+{
+    STAT_PLANES_COMPLETED,
+    STAT_PREEMPTIONS,
+    STAT_GRANTS_EMERGENCY,
+    STAT_GRANTS_NORMAL,
+    STAT_REQUEUES,
+    STAT_RUNWAY_BUSY_MS,         // Summed over all runways
+    STAT_PREEMPT_LATENCY_NS,     // Summed; divide by STAT_PREEMPTIONS for the mean
+    STAT_PREEMPT_LATENCY_MAX_NS, // Merged with max instead of sum
+    STAT_WAITS_EMERGENCY,        // Planes granted their first runway
+    STAT_WAITS_NORMAL,
+    STAT_WAIT_EMERGENCY_MS,      // Summed queue time before the first grant
+    STAT_WAIT_NORMAL_MS,
+    STAT_QUEUED_EMERGENCY,       // Gauges: planes waiting now (added on enqueue, subtracted on grant)
+    STAT_QUEUED_NORMAL,
+    STAT_SEPARATION_MS,          // Separation added to granted operations
+    STAT_SEQ_PLANS,              // Sequencer runs over normal_queue
+    STAT_SEQ_REORDERS,           // Runs that granted a plane out of arrival order
+    STAT_SEQ_FIFO_SPAN_MS,       // Summed window finish time in arrival order...
+    STAT_SEQ_PLAN_SPAN_MS,       // ...and in the planned order
+    STAT_SEQ_FIFO_COMPLETION_MS, // Summed per-window total completion time in arrival order...
+    STAT_SEQ_PLAN_COMPLETION_MS, // ...and in the planned order
+    STAT_COUNT
+} StatCounter;
+
+// Lifecycle phases reported per priority class
+typedef enum
+{
+    PHASE_QUEUE_WAIT,       // First queued until first grant
+    PHASE_SERVICE,          // Holding a runway (all grants)
+    PHASE_PREEMPT_OVERHEAD, // Off the runway between preemption and the next grant
+    PHASE_COUNT
+} LifecyclePhase;
+
+// One shard per cache line group so threads on different shards never share a line
+typedef struct
+{
+    _Alignas(64) atomic_long counters[STAT_COUNT];
+} StatShard;
+
+typedef struct
+{
+    StatShard shards[STATS_SHARDS];
+    atomic_int next_shard; // Round-robin shard assignment for new threads
+    // Log-linear wait-time histograms, [0] normal and [1] emergency. Waits are
+    // recorded at grant time under sched_sem, so these are not sharded.
+    atomic_long wait_buckets[2][STATS_WAIT_BUCKETS];
+    atomic_long wait_max_ms[2]; // Longest recorded wait; caps the percentiles
+    // Per-class lifecycle totals, added once per completed plane
+    atomic_long class_planes[PRIORITY_CLASS_COUNT];
+    atomic_long class_preemptions[PRIORITY_CLASS_COUNT];
+    atomic_long phase_sum_ns[PRIORITY_CLASS_COUNT][PHASE_COUNT];
+    atomic_long phase_max_ns[PRIORITY_CLASS_COUNT][PHASE_COUNT];
+} Stats;
+
+// Global statistics instance
+extern Stats runway_stats;
+
+// Statistics functions
+void stats_init(Stats *stats);
+void stats_add(Stats *stats, StatCounter counter, long value);
+void stats_max(Stats *stats, StatCounter counter, long value);
+long stats_read(Stats *stats, StatCounter counter);
+void stats_record_wait(Stats *stats, int emergency, long long wait_ms);
+double stats_wait_mean_ms(Stats *stats, int emergency);
+long long stats_wait_percentile_ms(Stats *stats, int emergency, double percentile);
+void stats_record_lifecycle(Stats *stats, int priority_class, const long long phase_ns[PHASE_COUNT], int preemptions);
+long stats_class_planes(Stats *stats, int priority_class);
+long stats_class_preemptions(Stats *stats, int priority_class);
+double stats_phase_mean_ns(Stats *stats, int priority_class, LifecyclePhase phase);
+long stats_phase_max_ns(Stats *stats, int priority_class, LifecyclePhase phase);
+
+#endif // STATS_H
@@ -0,0 +1,447 @@
+#define _DEFAULT_SOURCE // fork, pipe, sysconf
+
+#include "sweep.h"
+#include "runway.h"
+#include "sim.h"
+#include "pool.h"
+#include "stats.h"
+#include "policy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// A simulation instance is one forked process: the runway system, statistics
+// and pools are process globals, so each point gets its own copy and only the
+// SweepResult comes back through a pipe.
+
+// Parse "start[:end[:step]]" (step defaults to 1)
+int sweep_parse_range(const char *text, SweepRange *range)
+{
+    char *end;
+    range->start = (int)strtol(text, &end, 10);
+    range->end = range->start;
+    range->step = 1;
+    if (end == text)
+        return -1;
+    if (*end == ':')
+    {
+        text = end + 1;
+        range->end = (int)strtol(text, &end, 10);
+        if (end == text)
+            return -1;
+        if (*end == ':')
+        {
+            text = end + 1;
+            range->step = (int)strtol(text, &end, 10);
+            if (end == text)
+                return -1;
+        }
+    }
+    if (*end != '\0' || range->step <= 0 || range->end < range->start)
+        return -1;
+    return 0;
+}
+
+static int sweep_range_count(const SweepRange *range)
+{
+    return (range->end - range->start) / range->step + 1;
+}
+
+static int sweep_range_value(const SweepRange *range, int i)
+{
+    return range->start + i * range->step;
+}
+
+// Expand the ranges into grid points (planes vary slowest)
+static SweepPoint *sweep_build_grid(const SweepConfig *config, int *count)
+{
+    int n = sweep_range_count(&config->planes);
+    int e = sweep_range_count(&config->emergency_prob);
+    int l = sweep_range_count(&config->landing_duration);
+    int t = sweep_range_count(&config->takeoff_duration);
+    long total = (long)n * e * l * t;
+    if (total > SWEEP_MAX_POINTS)
+    {
+        fprintf(stderr, "Error: Sweep has %ld points (max %d)\n", total, SWEEP_MAX_POINTS);
+        return NULL;
+    }
+
+    SweepPoint *points = (SweepPoint *)malloc(total * sizeof(SweepPoint));
+    if (points == NULL)
+    {
+        perror("Failed to allocate sweep grid");
+        return NULL;
+    }
+
+    int k = 0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < e; j++)
+            for (int a = 0; a < l; a++)
+                for (int b = 0; b < t; b++)
+                {
+                    points[k].planes = sweep_range_value(&config->planes, i);
+                    points[k].emergency_prob = sweep_range_value(&config->emergency_prob, j);
+                    points[k].landing_duration = sweep_range_value(&config->landing_duration, a);
+                    points[k].takeoff_duration = sweep_range_value(&config->takeoff_duration, b);
+                    k++;
+                }
+    *count = k;
+    return points;
+}
+
+// Run one point on the virtual clock (child process, output suppressed)
+static int sweep_run_point(const SweepConfig *config, const SweepPoint *point, SweepResult *result)
+{
+    Workload workload;
+
+    runway_quiet = 1;
+    pool_init(&plane_pool, "plane", sizeof(Plane));
+    pool_init(&plane_cold_pool, "plane-cold", sizeof(PlaneCold));
+    pool_init(&queue_node_pool, "queue-node", sizeof(QueueNode));
+
+    runway_init(&runway_system, point->landing_duration, point->takeoff_duration);
+    runway_system.total_planes = point->planes;
+    if (runway_configure(&runway_system, config->runway_count, config->runway_roles) != 0)
+        return -1;
+    if (config->policy == &policy_aging)
+        runway_enable_priority_heap(&runway_system, config->aging_ms);
+    else
+        runway_set_policy(&runway_system, config->policy);
+
+    workload_init(&workload, config->pattern, point->planes, point->emergency_prob,
+                  config->landing_mix, config->seed);
+    sim_set_workload(&workload);
+    sim_virtual_mode = 1;
+    sim_run();
+
+    result->completed = stats_read(&runway_stats, STAT_PLANES_COMPLETED);
+    result->sim_ms = sim_now_ms();
+    for (int emergency = 0; emergency < 2; emergency++)
+    {
+        result->wait_mean_ms[emergency] = stats_wait_mean_ms(&runway_stats, emergency);
+        result->wait_p99_ms[emergency] = stats_wait_percentile_ms(&runway_stats, emergency, 99.0);
+    }
+    result->preemptions = stats_read(&runway_stats, STAT_PREEMPTIONS);
+    result->requeues = stats_read(&runway_stats, STAT_REQUEUES);
+    return 0;
+}
+
+// Fork a child for one point; returns its pid and the read end of its pipe
+static pid_t sweep_spawn(const SweepConfig *config, const SweepPoint *point, int index, int *read_fd)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        perror("Failed to create sweep pipe");
+        return -1;
+    }
+
+    fflush(NULL); // Don't let the child flush the parent's buffered output
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("Failed to fork sweep worker");
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        SweepResult result;
+        memset(&result, 0, sizeof(result));
+        result.index = index;
+        int status = sweep_run_point(config, point, &result);
+        // One write smaller than PIPE_BUF: the parent reads it after we exit
+        if (status == 0 && write(fds[1], &result, sizeof(result)) != (ssize_t)sizeof(result))
+            status = -1;
+        _exit(status == 0 ? 0 : 1);
+    }
+
+    close(fds[1]);
+    *read_fd = fds[0];
+    return pid;
+}
+
+static void sweep_write_csv(FILE *out, const SweepConfig *config, const SweepPoint *points,
+                            const SweepResult *results, const int *done, int count)
+{
+    fprintf(out, "planes,emergency_pct,landing_s,takeoff_s,runways,seed,completed,sim_seconds,"
+                 "throughput_per_hour,wait_mean_emergency_ms,wait_p99_emergency_ms,"
+                 "wait_mean_normal_ms,wait_p99_normal_ms,preemptions,requeues\n");
+    for (int i = 0; i < count; i++)
+    {
+        if (!done[i])
+            continue;
+        const SweepPoint *p = &points[i];
+        const SweepResult *r = &results[i];
+        double hours = r->sim_ms / 3600000.0;
+        fprintf(out, "%d,%d,%d,%d,%d,%llu,%ld,%.1f,%.2f,%.1f,%lld,%.1f,%lld,%ld,%ld\n",
+                p->planes, p->emergency_prob, p->landing_duration, p->takeoff_duration,
+                config->runway_count, (unsigned long long)config->seed, r->completed, r->sim_ms / 1000.0,
+                hours > 0 ? r->completed / hours : 0.0,
+                r->wait_mean_ms[1], r->wait_p99_ms[1], r->wait_mean_ms[0], r->wait_p99_ms[0],
+                r->preemptions, r->requeues);
+    }
+}
+
+// Run every grid point, at most config->jobs at a time, and write one CSV
+int sweep_run(const SweepConfig *config)
+{
+    int count = 0;
+    SweepPoint *points = sweep_build_grid(config, &count);
+    if (points == NULL)
+        return 1;
+
+    SweepResult *results = (SweepResult *)calloc(count, sizeof(SweepResult));
+    int *done = (int *)calloc(count, sizeof(int));
+    pid_t *pids = (pid_t *)malloc(config->jobs * sizeof(pid_t));
+    int *fds = (int *)malloc(config->jobs * sizeof(int));
+    int *slot_point = (int *)malloc(config->jobs * sizeof(int));
+    if (results == NULL || done == NULL || pids == NULL || fds == NULL || slot_point == NULL)
+    {
+        perror("Failed to allocate sweep results");
+        return 1;
+    }
+
+    fprintf(stderr, "[SWEEP] %d points on %d parallel simulations\n", count, config->jobs);
+
+    int next = 0;
+    int running = 0;
+    int failed = 0;
+    for (int s = 0; s < config->jobs; s++)
+        pids[s] = 0;
+
+    while (next < count || running > 0)
+    {
+        // Fill idle slots
+        for (int s = 0; s < config->jobs && next < count; s++)
+        {
+            if (pids[s] != 0)
+                continue;
+            pids[s] = sweep_spawn(config, &points[next], next, &fds[s]);
+            if (pids[s] < 0)
+            {
+                pids[s] = 0;
+                failed++;
+                next++;
+                continue;
+            }
+            slot_point[s] = next++;
+            running++;
+        }
+        if (running == 0)
+            break;
+
+        // Collect whichever simulation finishes first
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0)
+            break;
+        for (int s = 0; s < config->jobs; s++)
+        {
+            if (pids[s] != pid)
+                continue;
+            int index = slot_point[s];
+            SweepResult result;
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                read(fds[s], &result, sizeof(result)) == (ssize_t)sizeof(result) && result.index == index)
+            {
+                results[index] = result;
+                done[index] = 1;
+            }
+            else
+            {
+                fprintf(stderr, "Warning: sweep point %d (n=%d e=%d l=%d t=%d) failed\n", index + 1,
+                        points[index].planes, points[index].emergency_prob,
+                        points[index].landing_duration, points[index].takeoff_duration);
+                failed++;
+            }
+            close(fds[s]);
+            pids[s] = 0;
+            running--;
+            break;
+        }
+    }
+
+    FILE *out = stdout;
+    if (config->output_path != NULL && (out = fopen(config->output_path, "w")) == NULL)
+    {
+        perror("Failed to open sweep output");
+        out = stdout;
+    }
+    sweep_write_csv(out, config, points, results, done, count);
+    if (out != stdout)
+        fclose(out);
+
+    fprintf(stderr, "[SWEEP] %d points completed, %d failed\n", count - failed, failed);
+
+    free(points);
+    free(results);
+    free(done);
+    free(pids);
+    free(fds);
+    free(slot_point);
+    return failed > 0 ? 1 : 0;
+}
+
+static void sweep_usage(const char *program_name)
+{
+    printf("Usage: %s -S [options]\n\n", program_name);
+    printf("Runs one virtual-time simulation per grid point in parallel and writes a CSV.\n");
+    printf("Ranges are start[:end[:step]].\n\n");
+    printf("  -n <range>     Total number of planes (default: 1000)\n");
+    printf("  -e <range>     Emergency probability 0-100 (default: 15)\n");
+    printf("  -l <range>     Landing duration in seconds (default: 8)\n");
+    printf("  -t <range>     Takeoff duration in seconds (default: 6)\n");
+    printf("  -r <n>[:roles] Number of runways and their roles (default: 1)\n");
+    printf("  -p <policy>    Scheduling policy: %s (default: %s)\n", policy_names(), POLICY_DEFAULT->name);
+    printf("  -a <ms>        Aging policy with this aging interval\n");
+    printf("  -W <pattern>   Arrival pattern (default: uniform)\n");
+    printf("  -M <percent>   Share of flights that land (default: 50)\n");
+    printf("  -s <seed>      Seed shared by every point (default: time and pid)\n");
+    printf("  -j <jobs>      Parallel simulations (default: online CPUs)\n");
+    printf("  -o <file>      CSV output file (default: stdout)\n");
+}
+
+// Entry point for -S: parse range options and run the sweep
+int sweep_main(int argc, char *argv[])
+{
+    SweepConfig config;
+    sweep_parse_range("1000", &config.planes);
+    sweep_parse_range("15", &config.emergency_prob);
+    sweep_parse_range("8", &config.landing_duration);
+    sweep_parse_range("6", &config.takeoff_duration);
+    config.runway_count = 1;
+    config.runway_roles = NULL;
+    config.policy = NULL;
+    config.aging_ms = -1;
+    config.pattern = WORKLOAD_UNIFORM;
+    config.landing_mix = 50;
+    config.seed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+    config.jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    config.output_path = NULL;
+
+    int opt;
+    optind = 1;
+    while ((opt = getopt(argc, argv, "Sn:e:l:t:r:p:a:W:M:s:j:o:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'S':
+            break;
+        case 'n':
+            if (sweep_parse_range(optarg, &config.planes) != 0 || config.planes.start <= 0)
+            {
+                fprintf(stderr, "Error: Plane count range must be positive\n");
+                return 1;
+            }
+            break;
+        case 'e':
+            if (sweep_parse_range(optarg, &config.emergency_prob) != 0 ||
+                config.emergency_prob.start < 0 || config.emergency_prob.end > 100)
+            {
+                fprintf(stderr, "Error: Emergency probability range must be within 0-100\n");
+                return 1;
+            }
+            break;
+        case 'l':
+            if (sweep_parse_range(optarg, &config.landing_duration) != 0 || config.landing_duration.start <= 0)
+            {
+                fprintf(stderr, "Error: Landing duration range must be positive\n");
+                return 1;
+            }
+            break;
+        case 't':
+            if (sweep_parse_range(optarg, &config.takeoff_duration) != 0 || config.takeoff_duration.start <= 0)
+            {
+                fprintf(stderr, "Error: Takeoff duration range must be positive\n");
+                return 1;
+            }
+            break;
+        case 'r':
+            config.runway_count = atoi(optarg);
+            config.runway_roles = strchr(optarg, ':');
+            if (config.runway_roles != NULL)
+                config.runway_roles++;
+            if (config.runway_count <= 0 || config.runway_count > MAX_RUNWAYS)
+            {
+                fprintf(stderr, "Error: Runway count must be between 1 and %d\n", MAX_RUNWAYS);
+                return 1;
+            }
+            break;
+        case 'p':
+            config.policy = policy_find(optarg);
+            if (config.policy == NULL)
+            {
+                fprintf(stderr, "Error: Unknown scheduling policy %s (available: %s)\n", optarg, policy_names());
+                return 1;
+            }
+            break;
+        case 'a':
+            config.aging_ms = atoll(optarg);
+            if (config.aging_ms < 0)
+            {
+                fprintf(stderr, "Error: Aging interval must be zero or positive\n");
+                return 1;
+            }
+            break;
+        case 'W':
+            if (workload_parse_pattern(optarg, &config.pattern) != 0)
+            {
+                fprintf(stderr, "Error: Arrival pattern must be uniform, poisson, rush or storm\n");
+                return 1;
+            }
+            break;
+        case 'M':
+            config.landing_mix = atoi(optarg);
+            if (config.landing_mix < 0 || config.landing_mix > 100)
+            {
+                fprintf(stderr, "Error: Landing mix must be between 0 and 100\n");
+                return 1;
+            }
+            break;
+        case 's':
+            config.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'j':
+            config.jobs = atoi(optarg);
+            if (config.jobs <= 0)
+            {
+                fprintf(stderr, "Error: Job count must be positive\n");
+                return 1;
+            }
+            break;
+        case 'o':
+            config.output_path = optarg;
+            break;
+        case 'h':
+            sweep_usage(argv[0]);
+            return 0;
+        default:
+            sweep_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.jobs < 1)
+        config.jobs = 1;
+    if (config.aging_ms >= 0)
+    {
+        if (config.policy == NULL)
+            config.policy = policy_find("aging");
+        if (config.policy != &policy_aging)
+        {
+            fprintf(stderr, "Error: -a sets the aging interval of the aging policy (available: %s)\n", policy_names());
+            return 1;
+        }
+    }
+    if (config.policy == NULL)
+        config.policy = POLICY_DEFAULT;
+    if (config.policy == &policy_aging && config.aging_ms < 0)
+        config.aging_ms = POLICY_DEFAULT_AGING_MS;
+
+    return sweep_run(&config);
+}
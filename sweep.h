@@ -0,0 +1,63 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include "workload.h"
+
+#define SWEEP_MAX_POINTS 100000 // Grid points per sweep
+
+// Inclusive parameter range: start, start + step, ... up to end
+typedef struct
+{
+    int start;
+    int end;
+    int step;
+} SweepRange;
+
+// One grid point
+typedef struct
+{
+    int planes;
+    int emergency_prob;
+    int landing_duration;
+    int takeoff_duration;
+} SweepPoint;
+
+// Result of one point, written back by the child process that ran it
+typedef struct
+{
+    int index;
+    long completed;
+    long long sim_ms;
+    double wait_mean_ms[2]; // [0] normal, [1] emergency
+    long long wait_p99_ms[2];
+    long preemptions;
+    long requeues;
+} SweepResult;
+
+struct SchedPolicy;
+
+// Sweep settings shared by every point
+typedef struct
+{
+    SweepRange planes;
+    SweepRange emergency_prob;
+    SweepRange landing_duration;
+    SweepRange takeoff_duration;
+    int runway_count;
+    const char *runway_roles;
+    const struct SchedPolicy *policy; // Scheduling policy (policy.h)
+    long long aging_ms;      // Aging interval of the aging policy
+    WorkloadPattern pattern;
+    int landing_mix;
+    uint64_t seed;
+    int jobs;                // Simulations running at once
+    const char *output_path; // NULL = stdout
+} SweepConfig;
+
+// Sweep functions
+int sweep_parse_range(const char *text, SweepRange *range);
+int sweep_run(const SweepConfig *config);
+int sweep_main(int argc, char *argv[]);
+
+#endif // SWEEP_H
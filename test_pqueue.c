@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pqueue.h"
+#include "plane.h"
+
+// Unit tests for the priority heap (built and run by `make test`)
+
+#define TEST_PLANES 64
+
+static int test_failures = 0;
+static Plane planes[TEST_PLANES];
+
+static void expect_int(const char *what, long long actual, long long expected)
+{
+    if (actual != expected)
+    {
+        printf("FAIL %s: got %lld, expected %lld\n", what, actual, expected);
+        test_failures++;
+    }
+}
+
+// Plane id in the given class, not in any heap yet
+static Plane *test_plane(int id, int priority_class)
+{
+    Plane *plane = &planes[id];
+    memset(plane, 0, sizeof(*plane));
+    plane->id = id;
+    plane->heap_index = -1;
+    plane->priority_class = (unsigned char)priority_class;
+    return plane;
+}
+
+// Id of the next plane out of the heap, or -1 when it is empty
+static int extract_id(PQueue *pq)
+{
+    Plane *plane = pqueue_extract_min(pq);
+    return (plane != NULL) ? plane->id : -1;
+}
+
+// Lower classes come out first, and planes of one class in insertion order
+static void test_extract_min_order()
+{
+    PQueue pq;
+    pqueue_init(&pq, 4, 0);
+    const int classes[] = {2, 0, 3, 0, 1, 2, 1};
+    const int expected[] = {1, 3, 4, 6, 0, 5, 2};
+    for (int i = 0; i < 7; i++)
+        pqueue_insert(&pq, test_plane(i, classes[i]), 0);
+    expect_int("extract_min count", pqueue_get_count(&pq), 7);
+    expect_int("extract_min class 0 count", pqueue_level_count(&pq, 0), 2);
+
+    for (int i = 0; i < 7; i++)
+        expect_int("extract_min order", extract_id(&pq), expected[i]);
+    expect_int("extract_min empty", extract_id(&pq), -1);
+    expect_int("extract_min index cleared", planes[0].heap_index, -1);
+    pqueue_destroy(&pq);
+}
+
+// With aging, one class level is worth aging_ms of waiting
+static void test_extract_min_aging()
+{
+    PQueue pq;
+    pqueue_init(&pq, 4, 1000);
+    pqueue_insert(&pq, test_plane(0, 2), 0);    // Ranks as class 0 at 2000ms
+    pqueue_insert(&pq, test_plane(1, 0), 2500); // Arrived after that
+    pqueue_insert(&pq, test_plane(2, 0), 1500); // Arrived before that
+
+    expect_int("aging first", extract_id(&pq), 2);
+    expect_int("aging second", extract_id(&pq), 0);
+    expect_int("aging third", extract_id(&pq), 1);
+    pqueue_destroy(&pq);
+}
+
+// A plane raised to a more urgent class moves ahead of the planes it now outranks
+static void test_decrease_key()
+{
+    PQueue pq;
+    pqueue_init(&pq, 4, 0);
+    for (int i = 0; i < 6; i++)
+        pqueue_insert(&pq, test_plane(i, (i < 3) ? 1 : 3), 0);
+
+    expect_int("decrease_key", pqueue_decrease_key(&pq, &planes[5], 0), 0);
+    expect_int("decrease_key class", planes[5].priority_class, 0);
+    expect_int("decrease_key old level", pqueue_level_count(&pq, 3), 2);
+    expect_int("decrease_key new level", pqueue_level_count(&pq, 0), 1);
+    expect_int("decrease_key tie", pqueue_decrease_key(&pq, &planes[4], 1), 0);
+
+    // Raising is the only direction, and only for planes in the heap
+    expect_int("decrease_key same class", pqueue_decrease_key(&pq, &planes[3], 3), 0);
+    expect_int("decrease_key lower", pqueue_decrease_key(&pq, &planes[0], 2), -1);
+    expect_int("decrease_key lower class", planes[0].priority_class, 1);
+    Plane *outside = test_plane(TEST_PLANES - 1, 3);
+    expect_int("decrease_key outside", pqueue_decrease_key(&pq, outside, 0), -1);
+
+    // Plane 4 keeps its insertion order among the class 1 planes
+    const int expected[] = {5, 0, 1, 2, 4, 3};
+    for (int i = 0; i < 6; i++)
+        expect_int("decrease_key order", extract_id(&pq), expected[i]);
+    pqueue_destroy(&pq);
+}
+
+// Removing from the middle keeps the rest in order and the indexes valid.
+// Later planes are more urgent, so the last entry moved into a removed
+// slot sometimes has to go up rather than down.
+static void test_remove()
+{
+    PQueue pq;
+    pqueue_init(&pq, 4, 0);
+    for (int i = 0; i < TEST_PLANES - 1; i++)
+        pqueue_insert(&pq, test_plane(i, 3 - (i / 16) % 4), 0);
+
+    for (int i = 0; i < TEST_PLANES - 1; i += 3)
+        expect_int("remove", pqueue_remove(&pq, &planes[i]), 0);
+    expect_int("remove index cleared", planes[0].heap_index, -1);
+    expect_int("remove twice", pqueue_remove(&pq, &planes[0]), -1);
+    expect_int("remove count", pqueue_get_count(&pq), TEST_PLANES - 1 - (TEST_PLANES - 1 + 2) / 3);
+
+    // Survivors come out by class, then by id (their insertion order)
+    int previous = -1;
+    int extracted = 0;
+    Plane *plane;
+    while ((plane = pqueue_extract_min(&pq)) != NULL)
+    {
+        int rank = plane->priority_class * TEST_PLANES + plane->id;
+        if (plane->id % 3 == 0 || rank < previous)
+        {
+            printf("FAIL remove order: plane %d after rank %d\n", plane->id, previous);
+            test_failures++;
+        }
+        previous = rank;
+        extracted++;
+    }
+    expect_int("remove survivors", extracted, TEST_PLANES - 1 - (TEST_PLANES - 1 + 2) / 3);
+    pqueue_destroy(&pq);
+}
+
+int main()
+{
+    test_extract_min_order();
+    test_extract_min_aging();
+    test_decrease_key();
+    test_remove();
+
+    if (test_failures > 0)
+    {
+        printf("%d test(s) failed\n", test_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
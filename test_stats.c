@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "stats.h"
+
+// Unit tests for the statistics module (built and run by `make test`)
+
+static int test_failures = 0;
+
+// A histogram percentile is a bucket midpoint, within about 6% of the sample
+static void expect_near(const char *what, long long actual, long long expected)
+{
+    long long slack = expected / 16 + 1;
+    if (actual < expected - slack || actual > expected + slack)
+    {
+        printf("FAIL %s: got %lld, expected about %lld\n", what, actual, expected);
+        test_failures++;
+    }
+}
+
+static void test_percentile_empty()
+{
+    Stats stats;
+    stats_init(&stats);
+    expect_near("empty p99", stats_wait_percentile_ms(&stats, 0, 99.0), 0);
+}
+
+// Few samples with a long tail: p99 must land on the tail, not on the bulk
+static void test_percentile_sparse_tail()
+{
+    Stats stats;
+    stats_init(&stats);
+    stats_record_wait(&stats, 0, 0);
+    stats_record_wait(&stats, 0, 0);
+    stats_record_wait(&stats, 0, 1734);
+
+    expect_near("sparse p50", stats_wait_percentile_ms(&stats, 0, 50.0), 0);
+    expect_near("sparse p99", stats_wait_percentile_ms(&stats, 0, 99.0), 1734);
+    expect_near("sparse p100", stats_wait_percentile_ms(&stats, 0, 100.0), 1734);
+    expect_near("sparse p0", stats_wait_percentile_ms(&stats, 0, 0.0), 0);
+}
+
+// 98.9% short waits and a 1.1% tail: the 99th percentile sample is in the tail
+static void test_percentile_skewed()
+{
+    Stats stats;
+    stats_init(&stats);
+    for (int i = 0; i < 989; i++)
+        stats_record_wait(&stats, 1, 10);
+    for (int i = 0; i < 11; i++)
+        stats_record_wait(&stats, 1, 5000);
+
+    expect_near("skewed p50", stats_wait_percentile_ms(&stats, 1, 50.0), 10);
+    expect_near("skewed p98", stats_wait_percentile_ms(&stats, 1, 98.0), 10);
+    expect_near("skewed p99", stats_wait_percentile_ms(&stats, 1, 99.0), 5000);
+    expect_near("skewed normal p99", stats_wait_percentile_ms(&stats, 0, 99.0), 0);
+}
+
+static void expect_at_most(const char *what, long long actual, long long limit)
+{
+    if (actual > limit)
+    {
+        printf("FAIL %s: got %lld, above the recorded maximum %lld\n", what, actual, limit);
+        test_failures++;
+    }
+}
+
+// The tail sits near the bottom of its bucket, whose midpoint is above it
+static void test_percentile_top_bucket()
+{
+    Stats stats;
+    stats_init(&stats);
+    for (int i = 0; i < 98; i++)
+        stats_record_wait(&stats, 0, 100);
+    stats_record_wait(&stats, 0, 50000000);
+    stats_record_wait(&stats, 0, 50866988);
+
+    long long p99 = stats_wait_percentile_ms(&stats, 0, 99.0);
+    long long p100 = stats_wait_percentile_ms(&stats, 0, 100.0);
+    expect_at_most("top bucket p99", p99, 50866988);
+    expect_at_most("top bucket p100", p100, 50866988);
+    expect_near("top bucket p99", p99, 50866988);
+    expect_near("top bucket p100", p100, 50866988);
+}
+
+int main()
+{
+    test_percentile_empty();
+    test_percentile_sparse_tail();
+    test_percentile_skewed();
+    test_percentile_top_bucket();
+
+    if (test_failures > 0)
+    {
+        printf("%d test(s) failed\n", test_failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
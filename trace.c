@@ -0,0 +1,250 @@
+#define _DEFAULT_SOURCE // madvise
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Trace file format, one flight per line (blank lines and '#' comments ignored):
+//
+//   <arrival>,<operation>,<priority class>[,<duration seconds>]
+//
+// arrival is seconds (fractions allowed) or HH:MM[:SS]; operation is
+// LANDING/TAKEOFF (or L/T); the class is FUEL_CRITICAL, MEDICAL or SCHEDULED
+// (or F/M/S). Flights must be sorted by arrival; earlier times are clamped.
+// A first line that doesn't start with a digit is a column header.
+
+// Map the whole file read-only; pages are faulted in as the parser reaches them
+int trace_open(Trace *trace, const char *path)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->first_ms = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    trace->size = (size_t)st.st_size;
+    if (trace->size > 0)
+    {
+        void *data = mmap(NULL, trace->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            perror(path);
+            close(fd);
+            return -1;
+        }
+        madvise(data, trace->size, MADV_SEQUENTIAL);
+        trace->data = (const char *)data;
+    }
+
+    close(fd); // The mapping keeps the file open
+    return 0;
+}
+
+// Parse "HH:MM[:SS]" or "<seconds>[.<fraction>]" into milliseconds. Hours
+// may run past a day; minutes and seconds must be below 60.
+static int trace_parse_time(const char *text, long long *ms)
+{
+    char *end;
+    if (strchr(text, ':') != NULL)
+    {
+        long parts[3] = {0, 0, 0};
+        int count = 0;
+        const char *p = text;
+        do
+        {
+            if (!isdigit((unsigned char)*p))
+                return -1;
+            parts[count++] = strtol(p, &end, 10);
+            p = end + 1;
+        } while (*end == ':' && count < 3);
+        if (*end != '\0' || count < 2 || parts[1] > 59 || parts[2] > 59)
+            return -1;
+        *ms = ((long long)parts[0] * 3600 + parts[1] * 60 + parts[2]) * 1000;
+        return 0;
+    }
+
+    if (!isdigit((unsigned char)*text) && *text != '.')
+        return -1;
+    double seconds = strtod(text, &end);
+    if (end == text || *end != '\0')
+        return -1;
+    *ms = (long long)(seconds * 1000.0 + 0.5);
+    return 0;
+}
+
+static int trace_parse_operation(const char *text, OperationType *op)
+{
+    if (strcasecmp(text, "LANDING") == 0 || strcasecmp(text, "L") == 0)
+        *op = LANDING;
+    else if (strcasecmp(text, "TAKEOFF") == 0 || strcasecmp(text, "T") == 0)
+        *op = TAKEOFF;
+    else
+        return -1;
+    return 0;
+}
+
+static int trace_parse_class(const char *text, PriorityClass *priority_class)
+{
+    if (strcasecmp(text, "FUEL_CRITICAL") == 0 || strcasecmp(text, "F") == 0)
+        *priority_class = CLASS_FUEL_CRITICAL;
+    else if (strcasecmp(text, "MEDICAL") == 0 || strcasecmp(text, "M") == 0)
+        *priority_class = CLASS_MEDICAL;
+    else if (strcasecmp(text, "SCHEDULED") == 0 || strcasecmp(text, "S") == 0)
+        *priority_class = CLASS_SCHEDULED;
+    else
+        return -1;
+    return 0;
+}
+
+// Trim leading and trailing whitespace in place
+static char *trace_trim(char *text)
+{
+    while (isspace((unsigned char)*text))
+        text++;
+    char *end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1]))
+        *--end = '\0';
+    return text;
+}
+
+// Parse one line; returns 1 for a flight, 0 for a blank/comment line, -1 if
+// malformed (*problem then says what is wrong with it)
+static int trace_parse_line(char *line, TraceFlight *flight, const char **problem)
+{
+    char *text = trace_trim(line);
+    if (*text == '\0' || *text == '#')
+        return 0;
+
+    char *fields[4] = {NULL, NULL, NULL, NULL};
+    int count = 0;
+    char *save = NULL;
+    for (char *field = strtok_r(text, ",", &save); field != NULL && count < 4; field = strtok_r(NULL, ",", &save))
+        fields[count++] = trace_trim(field);
+
+    *problem = "expected arrival,operation,class[,duration]";
+    if (count < 3)
+        return -1;
+    *problem = "arrival must be seconds or HH:MM[:SS] with minutes and seconds below 60";
+    if (trace_parse_time(fields[0], &flight->arrival_ms) != 0)
+        return -1;
+    *problem = "operation must be LANDING/TAKEOFF or L/T";
+    if (trace_parse_operation(fields[1], &flight->operation) != 0)
+        return -1;
+    *problem = "class must be FUEL_CRITICAL/MEDICAL/SCHEDULED or F/M/S";
+    if (trace_parse_class(fields[2], &flight->priority_class) != 0)
+        return -1;
+
+    flight->duration = 0;
+    if (count == 4)
+    {
+        char *end;
+        *problem = "duration must be whole seconds";
+        long duration = strtol(fields[3], &end, 10);
+        if (!isdigit((unsigned char)*fields[3]) || *end != '\0' || duration > INT_MAX)
+            return -1;
+        flight->duration = (int)duration;
+    }
+    return 1;
+}
+
+// Read the next flight; returns 1 on success, 0 at end of file
+int trace_next(Trace *trace, TraceFlight *flight)
+{
+    char line[TRACE_MAX_LINE];
+
+    while (trace->pos < trace->size)
+    {
+        const char *start = trace->data + trace->pos;
+        const char *newline = memchr(start, '\n', trace->size - trace->pos);
+        size_t length = (newline != NULL) ? (size_t)(newline - start) : trace->size - trace->pos;
+        trace->pos += length + (newline != NULL);
+        trace->line++;
+
+        // Hand parsed pages back so long schedules replay in constant memory
+        if (trace->pos - trace->released >= TRACE_RELEASE_BYTES)
+        {
+            size_t page = (size_t)sysconf(_SC_PAGESIZE);
+            size_t end = trace->pos / page * page;
+            madvise((char *)trace->data + trace->released, end - trace->released, MADV_DONTNEED);
+            trace->released = end;
+        }
+
+        if (length >= sizeof(line))
+        {
+            fprintf(stderr, "Warning: trace line %ld skipped: longer than %d characters\n",
+                    trace->line, TRACE_MAX_LINE - 1);
+            trace->skipped++;
+            continue;
+        }
+        memcpy(line, start, length);
+        line[length] = '\0';
+
+        // Flights start with their arrival time, so a first line that does
+        // not start with a digit is a column header
+        const char *first = line;
+        while (isspace((unsigned char)*first))
+            first++;
+        if (trace->line == 1 && *first != '\0' && *first != '#' && !isdigit((unsigned char)*first))
+            continue;
+
+        const char *problem = NULL;
+        int parsed = trace_parse_line(line, flight, &problem);
+        if (parsed == 0)
+            continue;
+        if (parsed < 0)
+        {
+            fprintf(stderr, "Warning: trace line %ld skipped: %s\n", trace->line, problem);
+            trace->skipped++;
+            continue;
+        }
+
+        if (trace->first_ms < 0)
+        {
+            trace->first_ms = flight->arrival_ms;
+            trace->last_ms = flight->arrival_ms;
+        }
+        if (flight->arrival_ms < trace->last_ms)
+            flight->arrival_ms = trace->last_ms; // Unsorted input: arrive with the previous flight
+        trace->last_ms = flight->arrival_ms;
+        flight->arrival_ms -= trace->first_ms;
+        trace->flights++;
+        return 1;
+    }
+    return 0;
+}
+
+// Set up a plane for a flight read from the trace
+void trace_plane_init(Plane *plane, int id, const TraceFlight *flight)
+{
+    plane_init(plane, id, flight->operation, priority_class_level(flight->priority_class));
+    plane->priority_class = flight->priority_class;
+    plane->duration = flight->duration;
+}
+
+// Unmap the file
+void trace_close(Trace *trace)
+{
+    if (trace->data != NULL)
+        munmap((void *)trace->data, trace->size);
+    trace->data = NULL;
+    trace->size = 0;
+}
@@ -0,0 +1,39 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include "plane.h"
+
+#define TRACE_MAX_LINE 256                  // Longest line accepted
+#define TRACE_RELEASE_BYTES (16 * 1024 * 1024) // Drop parsed pages every 16MB
+
+// One scheduled flight from a trace file
+typedef struct
+{
+    long long arrival_ms; // Offset from the first flight in the trace
+    OperationType operation;
+    PriorityClass priority_class;
+    int duration;         // Seconds on the runway (0 = runway default)
+} TraceFlight;
+
+// Memory-mapped flight schedule, parsed one line at a time
+typedef struct
+{
+    const char *data;
+    size_t size;
+    size_t pos;         // Start of the next unparsed line
+    size_t released;    // Bytes already handed back with madvise
+    long line;          // Line number of the last line read
+    long flights;       // Flights returned so far
+    long skipped;       // Malformed lines ignored
+    long long first_ms; // Arrival time of the first flight (-1 before it)
+    long long last_ms;  // Arrival time of the previous flight
+} Trace;
+
+// Trace functions
+int trace_open(Trace *trace, const char *path);
+int trace_next(Trace *trace, TraceFlight *flight);
+void trace_plane_init(Plane *plane, int id, const TraceFlight *flight);
+void trace_close(Trace *trace);
+
+#endif // TRACE_H
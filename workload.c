@@ -0,0 +1,226 @@
+#include "workload.h"
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+// SplitMix64 step, used to expand a seed into generator state
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Seed one stream; different streams of the same seed are independent
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream)
+{
+    uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = splitmix64(&x);
+}
+
+// xoshiro256** next value
+uint64_t rng_next(Rng *rng)
+{
+    uint64_t *s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+// Uniform double in [0, 1)
+double rng_uniform(Rng *rng)
+{
+    return (rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+// Uniform integer in [0, bound) without modulo bias (Lemire's method)
+uint32_t rng_below(Rng *rng, uint32_t bound)
+{
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound)
+    {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold)
+        {
+            m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// Initialize a generator for total_planes flights
+void workload_init(Workload *workload, WorkloadPattern pattern, int total_planes,
+                   int emergency_prob, int landing_pct, uint64_t seed)
+{
+    workload->pattern = pattern;
+    workload->total_planes = total_planes;
+    workload->emergency_prob = emergency_prob;
+    workload->landing_pct = landing_pct;
+    workload->seed = seed;
+
+    rng_seed(&workload->gap_rng, seed, 1);
+    rng_seed(&workload->operation_rng, seed, 2);
+    rng_seed(&workload->priority_rng, seed, 3);
+
+    workload->clock_ms = 0;
+    workload->generated = 0;
+    workload->batch_count = 0;
+    workload->batch_pos = 0;
+    workload->trace = NULL;
+}
+
+// Replay a trace instead of generating flights
+void workload_set_trace(Workload *workload, Trace *trace)
+{
+    workload->trace = trace;
+}
+
+// Exponential gap with the given mean
+static long long workload_exponential_ms(Rng *rng, double mean_ms)
+{
+    return (long long)(-log(1.0 - rng_uniform(rng)) * mean_ms);
+}
+
+// Time until the next arrival after clock_ms
+static long long workload_gap_ms(Workload *workload)
+{
+    switch (workload->pattern)
+    {
+    case WORKLOAD_POISSON:
+    case WORKLOAD_STORM:
+        return workload_exponential_ms(&workload->gap_rng, WORKLOAD_MEAN_GAP_MS);
+    case WORKLOAD_RUSH:
+        if (workload->clock_ms % WORKLOAD_RUSH_PERIOD_MS < WORKLOAD_RUSH_MS)
+            return workload_exponential_ms(&workload->gap_rng, (double)WORKLOAD_MEAN_GAP_MS / WORKLOAD_RUSH_FACTOR);
+        return workload_exponential_ms(&workload->gap_rng, WORKLOAD_MEAN_GAP_MS);
+    default:
+        return 1000 + rng_below(&workload->gap_rng, 2000);
+    }
+}
+
+// Emergency probability in effect at time_ms
+static int workload_emergency_prob(Workload *workload, long long time_ms)
+{
+    if (workload->pattern == WORKLOAD_STORM && time_ms % WORKLOAD_STORM_PERIOD_MS < WORKLOAD_STORM_MS)
+    {
+        int storm = workload->emergency_prob * 4;
+        if (storm < WORKLOAD_STORM_PROB)
+            storm = WORKLOAD_STORM_PROB;
+        return (storm > 100) ? 100 : storm;
+    }
+    return workload->emergency_prob;
+}
+
+// Generate the next batch of flights
+static void workload_refill(Workload *workload)
+{
+    int count = workload->total_planes - workload->generated;
+    if (count > WORKLOAD_BATCH)
+        count = WORKLOAD_BATCH;
+
+    for (int i = 0; i < count; i++)
+    {
+        TraceFlight *flight = &workload->batch[i];
+
+        // The first flight arrives at time zero
+        if (workload->generated + i > 0)
+            workload->clock_ms += workload_gap_ms(workload);
+        flight->arrival_ms = workload->clock_ms;
+
+        flight->operation = ((int)rng_below(&workload->operation_rng, 100) < workload->landing_pct) ? LANDING : TAKEOFF;
+
+        // One in three emergencies is fuel-critical
+        if ((int)rng_below(&workload->priority_rng, 100) < workload_emergency_prob(workload, flight->arrival_ms))
+            flight->priority_class = (rng_below(&workload->priority_rng, 3) == 0) ? CLASS_FUEL_CRITICAL : CLASS_MEDICAL;
+        else
+            flight->priority_class = CLASS_SCHEDULED;
+        flight->duration = 0;
+    }
+
+    workload->generated += count;
+    workload->batch_count = count;
+    workload->batch_pos = 0;
+}
+
+// Next flight in arrival order; returns 1 on success, 0 once traffic is exhausted
+int workload_next(Workload *workload, TraceFlight *flight)
+{
+    if (workload->trace != NULL)
+        return trace_next(workload->trace, flight);
+
+    if (workload->batch_pos == workload->batch_count)
+    {
+        workload_refill(workload);
+        if (workload->batch_count == 0)
+            return 0;
+    }
+    *flight = workload->batch[workload->batch_pos++];
+    return 1;
+}
+
+// Change the parameters of traffic not generated yet: keeps the next pending
+// flight and regenerates everything after it from the new seed
+void workload_fork(Workload *workload, WorkloadPattern pattern, int emergency_prob, int landing_pct, uint64_t seed)
+{
+    int remaining = workload->batch_count - workload->batch_pos;
+    if (remaining > 0)
+    {
+        workload->batch[0] = workload->batch[workload->batch_pos];
+        workload->clock_ms = workload->batch[0].arrival_ms;
+        workload->generated -= remaining - 1;
+        workload->batch_count = 1;
+        workload->batch_pos = 0;
+    }
+
+    workload->pattern = pattern;
+    workload->emergency_prob = emergency_prob;
+    workload->landing_pct = landing_pct;
+    workload->seed = seed;
+    rng_seed(&workload->gap_rng, seed, 1);
+    rng_seed(&workload->operation_rng, seed, 2);
+    rng_seed(&workload->priority_rng, seed, 3);
+}
+
+int workload_parse_pattern(const char *name, WorkloadPattern *pattern)
+{
+    for (int p = WORKLOAD_UNIFORM; p <= WORKLOAD_STORM; p++)
+    {
+        if (strcasecmp(name, workload_pattern_to_string(p)) == 0)
+        {
+            *pattern = p;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *workload_pattern_to_string(WorkloadPattern pattern)
+{
+    switch (pattern)
+    {
+    case WORKLOAD_POISSON:
+        return "poisson";
+    case WORKLOAD_RUSH:
+        return "rush";
+    case WORKLOAD_STORM:
+        return "storm";
+    default:
+        return "uniform";
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+#include "plane.h"
+#include "trace.h"
+
+#define WORKLOAD_BATCH 1024           // Flights generated per refill
+#define WORKLOAD_MEAN_GAP_MS 2000     // Mean time between arrivals
+#define WORKLOAD_RUSH_PERIOD_MS 3600000 // Rush hour: first quarter of every hour...
+#define WORKLOAD_RUSH_MS 900000
+#define WORKLOAD_RUSH_FACTOR 4          // ...at four times the arrival rate
+#define WORKLOAD_STORM_PERIOD_MS 1800000 // Emergency storm: 5 minutes every 30...
+#define WORKLOAD_STORM_MS 300000
+#define WORKLOAD_STORM_PROB 50           // ...with at least 50% emergencies
+
+// Arrival pattern for generated traffic
+typedef enum
+{
+    WORKLOAD_UNIFORM, // 1-3 s between arrivals (the classic demo pacing)
+    WORKLOAD_POISSON, // Exponential gaps around WORKLOAD_MEAN_GAP_MS
+    WORKLOAD_RUSH,    // Poisson with periodic rush-hour bursts
+    WORKLOAD_STORM    // Poisson with periodic emergency storms
+} WorkloadPattern;
+
+// xoshiro256** generator; one per independent random stream
+typedef struct
+{
+    uint64_t s[4];
+} Rng;
+
+// Traffic source: generated flights, or a replayed trace when one is set
+typedef struct
+{
+    WorkloadPattern pattern;
+    int total_planes;
+    int emergency_prob; // Percent
+    int landing_pct;    // Percent of flights that land
+    uint64_t seed;
+
+    // Separate streams so e.g. changing the mix leaves arrival times alone
+    Rng gap_rng;
+    Rng operation_rng;
+    Rng priority_rng;
+
+    long long clock_ms; // Arrival time of the last generated flight
+    int generated;
+    TraceFlight batch[WORKLOAD_BATCH];
+    int batch_count;
+    int batch_pos;
+
+    Trace *trace;
+} Workload;
+
+// RNG functions
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+uint64_t rng_next(Rng *rng);
+double rng_uniform(Rng *rng);
+uint32_t rng_below(Rng *rng, uint32_t bound);
+
+// Workload functions
+void workload_init(Workload *workload, WorkloadPattern pattern, int total_planes,
+                   int emergency_prob, int landing_pct, uint64_t seed);
+void workload_set_trace(Workload *workload, Trace *trace);
+int workload_next(Workload *workload, TraceFlight *flight);
+void workload_fork(Workload *workload, WorkloadPattern pattern, int emergency_prob, int landing_pct, uint64_t seed);
+int workload_parse_pattern(const char *name, WorkloadPattern *pattern);
+const char *workload_pattern_to_string(WorkloadPattern pattern);
+
+#endif // WORKLOAD_H